@@ -0,0 +1,844 @@
+// ordered map as a B+-tree with wide nodes from a node pool
+// a node holds up to `slots` keys, sized so the keys span a few cache lines
+// (64 ints, 8 strings), so a lookup touches a handful of nodes instead of
+// one pointer per level as in a red-black tree; nodes come from chunked
+// pools, so neighbouring nodes tend to share pages
+//
+// values live only in the leaves, which are linked: a range scan walks
+// the leaf chain without going back up the tree. bulk_load() builds the
+// tree bottom-up from sorted input in O(n)
+
+/*
+ *              [ 17 | 42 ]                 inner: separator keys
+ *            /      |      \
+ *  [ 3 .. 15 ] <-> [ 17 .. 40 ] <-> [ 42 .. 90 ]   leaves: keys and values
+ */
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "ForkFlatMap.hpp"  // fork_lower_bound
+#include "ForkStats.hpp"
+#include "ForkVector.hpp"
+
+template <typename K, typename V, typename Compare = std::less<>>
+class ForkBTreeMap {
+public:
+  using value_type           = V;
+  static constexpr int bytes = 256;  // key bytes per node, four cache lines
+  static constexpr int slots = bytes / static_cast<int>(sizeof(K)) < 4    ? 4
+                               : bytes / static_cast<int>(sizeof(K)) > 64 ? 64
+                               : bytes / static_cast<int>(sizeof(K));
+
+private:
+  using stats = ForkStatsOf<ForkBTreeMap>;  // no-op unless FORK_STL_STATS
+
+  class Node {
+  public:
+    int count = 0;
+    K keys[slots];
+  };
+  class Leaf : public Node {
+  public:
+    V values[slots];
+    Leaf *prev = nullptr;
+    Leaf *next = nullptr;
+  };
+  class Inner : public Node {
+  public:
+    Node *children[slots + 1] = {};  // keys[i] is the least key of [i + 1]
+  };
+
+  // fixed-size node storage, carved from chunks and recycled on a free list
+  template <typename N>
+  class Pool {
+  public:
+    static constexpr int chunk = 64;  // nodes per allocation
+    ForkVector<N *> chunks;
+    ForkVector<N *> free;
+    Pool() = default;
+    Pool(Pool &&other) noexcept = default;
+    Pool &operator=(Pool &&other) noexcept = default;
+    ~Pool();
+    N *acquire();
+    void release(N *node);
+  };
+
+  Pool<Leaf> leaves;
+  Pool<Inner> inners;
+  Node *root = nullptr;
+  int height = 0;  // levels of inner nodes above the leaves
+  int size   = 0;
+  Compare compare;
+
+  class Split {
+  public:
+    Node *right = nullptr;  // new right sibling, nullptr if no split
+    K separator;            // least key under right
+  };
+
+  template <typename Q>
+  int lower_index(const Node *node, const Q &key) const;
+  template <typename Q>
+  int upper_index(const Node *node, const Q &key) const;
+  template <typename Q>
+  Leaf *leaf_for(const Q &key) const;
+  template <typename Q>
+  V *value_for(const Q &key) const;  // nullptr if absent
+  Leaf *leftmost() const;            // nullptr if empty
+  Split insert_into(Node *node, const int &level, const K &key,
+                    const V &value, V *&slot, bool &added);
+  Split insert_child(Inner *node, const int &index, const Split &split);
+  template <typename Q>
+  bool erase_from(Node *node, const int &level, const Q &key);
+  void fix_child(Inner *node, const int &index, const int &level);
+  void release_tree(Node *node, const int &level);
+  V &emplace(const K &key, const V &value, bool &added);
+
+public:
+  // iterator yields V &, const_iterator (from a const map) const V &
+  template <bool Const>
+  class basic_iterator {
+  private:
+    using value_ref = std::conditional_t<Const, const V &, V &>;
+    Leaf *leaf;
+    int index;
+
+  public:
+    basic_iterator(Leaf *leaf, int index) : leaf(leaf), index(index) {
+      if (leaf != nullptr && index >= leaf->count) {
+        this->leaf  = leaf->next;  // past the end of a leaf
+        this->index = 0;
+      }
+    }
+    operator basic_iterator<true>() const
+      requires(!Const)
+    {
+      return {leaf, index};
+    }
+    const K &key() const { return leaf->keys[index]; }
+    value_ref value() const { return leaf->values[index]; }
+    std::pair<const K &, value_ref> operator*() const {
+      return {key(), value()};
+    }
+    basic_iterator &operator++() {
+      if (++index == leaf->count) {
+        leaf  = leaf->next;
+        index = 0;
+      }
+      return *this;
+    }
+    bool operator==(const basic_iterator &other) const {
+      return leaf == other.leaf && index == other.index;
+    }
+    bool operator!=(const basic_iterator &other) const {
+      return !(*this == other);
+    }
+  };
+  using iterator       = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  // constructor and destructor
+  explicit ForkBTreeMap(const Compare &compare = Compare());
+  ~ForkBTreeMap();
+  ForkBTreeMap(const ForkBTreeMap &other);
+  ForkBTreeMap(ForkBTreeMap &&other) noexcept;
+
+  // functions
+  bool insert(const K &key, const V &value);  // false if the key exists
+  void insert_or_assign(const K &key, const V &value);
+  template <typename InputIt>
+  void bulk_load(InputIt first, InputIt last);  // sorted unique pairs
+  template <typename Q>
+  bool erase(const Q &key);  // false if absent
+  void erase();              // remove everything
+  template <typename Q>
+  V *find(const Q &key);  // nullptr if absent
+  template <typename Q>
+  const V *find(const Q &key) const;
+  template <typename Q>
+  [[nodiscard]] bool contains(const Q &key) const;
+  template <typename Q>
+  V &get(const Q &key);  // throws if absent
+  template <typename Q>
+  const V &get(const Q &key) const;
+  template <typename Q>
+  iterator lower_bound(const Q &key);  // first key >= key
+  template <typename Q>
+  const_iterator lower_bound(const Q &key) const;
+  template <typename Q>
+  iterator upper_bound(const Q &key);  // first key > key
+  template <typename Q>
+  const_iterator upper_bound(const Q &key) const;
+  iterator begin() { return iterator(leftmost(), 0); }
+  const_iterator begin() const { return const_iterator(leftmost(), 0); }
+  iterator end() { return iterator(nullptr, 0); }
+  const_iterator end() const { return const_iterator(nullptr, 0); }
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] int get_height() const;  // inner levels above the leaves
+  [[nodiscard]] bool is_empty() const;
+
+  // operator overloading
+  V &operator[](const K &key);  // inserts V() if absent
+  ForkBTreeMap &operator=(const ForkBTreeMap &other);
+  ForkBTreeMap &operator=(ForkBTreeMap &&other) noexcept;
+
+  // echo
+  void echo() const;
+};
+
+// Pool
+
+// destructor (every node must be released already)
+template <typename K, typename V, typename Compare>
+template <typename N>
+ForkBTreeMap<K, V, Compare>::Pool<N>::~Pool() {
+  for (int i = 0; i < chunks.GetSize(); i++) {
+    std::allocator<N>().deallocate(chunks[i], chunk);
+    stats::release(chunk * sizeof(N));
+  }
+}
+// acquire
+template <typename K, typename V, typename Compare>
+template <typename N>
+N *ForkBTreeMap<K, V, Compare>::Pool<N>::acquire() {
+  if (free.GetSize() == 0) {
+    N *memory = std::allocator<N>().allocate(chunk);
+    stats::allocate(chunk * sizeof(N));
+    chunks.push_back(memory);
+    for (int i = chunk - 1; i >= 0; i--) {
+      free.push_back(memory + i);  // hand out ascending addresses
+    }
+  }
+  N *node = free[free.GetSize() - 1];
+  free.pop_back();
+  return new (node) N();
+}
+// release
+template <typename K, typename V, typename Compare>
+template <typename N>
+void ForkBTreeMap<K, V, Compare>::Pool<N>::release(N *node) {
+  node->~N();
+  free.push_back(node);
+}
+
+// ForkBTreeMap
+
+// lower_index (first key in the node not less than key)
+template <typename K, typename V, typename Compare>
+template <typename Q>
+int ForkBTreeMap<K, V, Compare>::lower_index(const Node *node,
+                                             const Q &key) const {
+  return fork_lower_bound(node->keys, node->count, key, compare);
+}
+// upper_index (first key in the node greater than key)
+template <typename K, typename V, typename Compare>
+template <typename Q>
+int ForkBTreeMap<K, V, Compare>::upper_index(const Node *node,
+                                             const Q &key) const {
+  auto not_greater = [this](const K &a, const Q &b) { return !compare(b, a); };
+  return fork_lower_bound(node->keys, node->count, key, not_greater);
+}
+// leaf_for
+template <typename K, typename V, typename Compare>
+template <typename Q>
+typename ForkBTreeMap<K, V, Compare>::Leaf *
+ForkBTreeMap<K, V, Compare>::leaf_for(const Q &key) const {
+  if (root == nullptr) {
+    return nullptr;
+  }
+  Node *node = root;
+  for (int level = height; level > 0; level--) {
+    node = static_cast<Inner *>(node)->children[upper_index(node, key)];
+  }
+  return static_cast<Leaf *>(node);
+}
+// value_for
+template <typename K, typename V, typename Compare>
+template <typename Q>
+V *ForkBTreeMap<K, V, Compare>::value_for(const Q &key) const {
+  Leaf *leaf = leaf_for(key);
+  if (leaf == nullptr) {
+    return nullptr;
+  }
+  int index = lower_index(leaf, key);
+  if (index == leaf->count || compare(key, leaf->keys[index])) {
+    return nullptr;
+  }
+  return leaf->values + index;
+}
+// leftmost
+template <typename K, typename V, typename Compare>
+typename ForkBTreeMap<K, V, Compare>::Leaf *
+ForkBTreeMap<K, V, Compare>::leftmost() const {
+  if (root == nullptr) {
+    return nullptr;
+  }
+  Node *node = root;
+  for (int level = height; level > 0; level--) {
+    node = static_cast<Inner *>(node)->children[0];
+  }
+  return static_cast<Leaf *>(node);
+}
+// insert_into (returns the new right sibling when node had to split)
+template <typename K, typename V, typename Compare>
+typename ForkBTreeMap<K, V, Compare>::Split
+ForkBTreeMap<K, V, Compare>::insert_into(Node *node, const int &level,
+                                         const K &key, const V &value,
+                                         V *&slot, bool &added) {
+  if (level > 0) {
+    auto *inner = static_cast<Inner *>(node);
+    int index   = upper_index(inner, key);
+    Split split =
+        insert_into(inner->children[index], level - 1, key, value, slot, added);
+    return split.right == nullptr ? split : insert_child(inner, index, split);
+  }
+  auto *leaf = static_cast<Leaf *>(node);
+  int index  = lower_index(leaf, key);
+  if (index < leaf->count && !compare(key, leaf->keys[index])) {
+    slot  = leaf->values + index;
+    added = false;
+    return Split();
+  }
+  added = true;
+  Split split;
+  if (leaf->count == slots) {  // split in halves, then insert into one
+    Leaf *right = leaves.acquire();
+    int half    = slots / 2;
+    for (int i = half; i < slots; i++) {
+      right->keys[i - half]   = std::move(leaf->keys[i]);
+      right->values[i - half] = std::move(leaf->values[i]);
+    }
+    right->count = slots - half;
+    leaf->count  = half;
+    right->next  = leaf->next;
+    right->prev  = leaf;
+    if (leaf->next != nullptr) {
+      leaf->next->prev = right;
+    }
+    leaf->next  = right;
+    split.right = right;
+    if (index > half) {
+      leaf = right;
+      index -= half;
+    }
+  }
+  for (int i = leaf->count; i > index; i--) {
+    leaf->keys[i]   = std::move(leaf->keys[i - 1]);
+    leaf->values[i] = std::move(leaf->values[i - 1]);
+  }
+  leaf->keys[index]   = key;
+  leaf->values[index] = value;
+  ++leaf->count;
+  slot = leaf->values + index;
+  if (split.right != nullptr) {
+    split.separator = split.right->keys[0];
+  }
+  return split;
+}
+// insert_child (hang split.right after children[index], may split node)
+template <typename K, typename V, typename Compare>
+typename ForkBTreeMap<K, V, Compare>::Split
+ForkBTreeMap<K, V, Compare>::insert_child(Inner *node, const int &index,
+                                          const Split &split) {
+  Split up;
+  Inner *target = node;
+  int at        = index;
+  if (node->count == slots) {
+    int mid      = slots / 2;
+    Inner *right = inners.acquire();
+    for (int i = mid + 1; i < slots; i++) {
+      right->keys[i - mid - 1] = std::move(node->keys[i]);
+    }
+    for (int i = mid + 1; i <= slots; i++) {
+      right->children[i - mid - 1] = node->children[i];
+    }
+    right->count = slots - mid - 1;
+    node->count  = mid;
+    up.right     = right;
+    up.separator = std::move(node->keys[mid]);
+    if (index > mid) {
+      target = right;
+      at     = index - mid - 1;
+    }
+  }
+  for (int i = target->count; i > at; i--) {
+    target->keys[i]         = std::move(target->keys[i - 1]);
+    target->children[i + 1] = target->children[i];
+  }
+  target->keys[at]         = split.separator;
+  target->children[at + 1] = split.right;
+  ++target->count;
+  return up;
+}
+// erase_from (true if the key was found below node)
+template <typename K, typename V, typename Compare>
+template <typename Q>
+bool ForkBTreeMap<K, V, Compare>::erase_from(Node *node, const int &level,
+                                             const Q &key) {
+  if (level > 0) {
+    auto *inner = static_cast<Inner *>(node);
+    int index   = upper_index(inner, key);
+    if (!erase_from(inner->children[index], level - 1, key)) {
+      return false;
+    }
+    if (inner->children[index]->count < slots / 2) {
+      fix_child(inner, index, level - 1);
+    }
+    return true;
+  }
+  auto *leaf = static_cast<Leaf *>(node);
+  int index  = lower_index(leaf, key);
+  if (index == leaf->count || compare(key, leaf->keys[index])) {
+    return false;
+  }
+  for (int i = index; i + 1 < leaf->count; i++) {
+    leaf->keys[i]   = std::move(leaf->keys[i + 1]);
+    leaf->values[i] = std::move(leaf->values[i + 1]);
+  }
+  --leaf->count;
+  leaf->keys[leaf->count]   = K();  // drop what the vacated slot holds
+  leaf->values[leaf->count] = V();
+  return true;
+}
+// fix_child (children[index] underflowed: borrow from a sibling or merge)
+template <typename K, typename V, typename Compare>
+void ForkBTreeMap<K, V, Compare>::fix_child(Inner *node, const int &index,
+                                            const int &level) {
+  int min     = slots / 2;
+  Node *child = node->children[index];
+  Node *left  = index > 0 ? node->children[index - 1] : nullptr;
+  Node *right = index < node->count ? node->children[index + 1] : nullptr;
+  if (level == 0) {
+    auto *c = static_cast<Leaf *>(child);
+    if (left != nullptr && left->count > min) {
+      auto *l = static_cast<Leaf *>(left);
+      for (int i = c->count; i > 0; i--) {
+        c->keys[i]   = std::move(c->keys[i - 1]);
+        c->values[i] = std::move(c->values[i - 1]);
+      }
+      c->keys[0]   = std::move(l->keys[l->count - 1]);
+      c->values[0] = std::move(l->values[l->count - 1]);
+      ++c->count;
+      --l->count;
+      node->keys[index - 1] = c->keys[0];
+      return;
+    }
+    if (right != nullptr && right->count > min) {
+      auto *r             = static_cast<Leaf *>(right);
+      c->keys[c->count]   = std::move(r->keys[0]);
+      c->values[c->count] = std::move(r->values[0]);
+      ++c->count;
+      for (int i = 0; i + 1 < r->count; i++) {
+        r->keys[i]   = std::move(r->keys[i + 1]);
+        r->values[i] = std::move(r->values[i + 1]);
+      }
+      --r->count;
+      node->keys[index] = r->keys[0];
+      return;
+    }
+    // merge with a sibling: the right one of the pair folds into the left
+    int at  = left != nullptr ? index - 1 : index;
+    auto *l = static_cast<Leaf *>(node->children[at]);
+    auto *r = static_cast<Leaf *>(node->children[at + 1]);
+    for (int i = 0; i < r->count; i++) {
+      l->keys[l->count + i]   = std::move(r->keys[i]);
+      l->values[l->count + i] = std::move(r->values[i]);
+    }
+    l->count += r->count;
+    l->next = r->next;
+    if (r->next != nullptr) {
+      r->next->prev = l;
+    }
+    leaves.release(r);
+    for (int i = at; i + 1 < node->count; i++) {
+      node->keys[i]         = std::move(node->keys[i + 1]);
+      node->children[i + 1] = node->children[i + 2];
+    }
+    --node->count;
+    return;
+  }
+  auto *c = static_cast<Inner *>(child);
+  if (left != nullptr && left->count > min) {
+    auto *l = static_cast<Inner *>(left);
+    for (int i = c->count; i > 0; i--) {
+      c->keys[i] = std::move(c->keys[i - 1]);
+    }
+    for (int i = c->count + 1; i > 0; i--) {
+      c->children[i] = c->children[i - 1];
+    }
+    c->keys[0]            = std::move(node->keys[index - 1]);
+    c->children[0]        = l->children[l->count];
+    node->keys[index - 1] = std::move(l->keys[l->count - 1]);
+    ++c->count;
+    --l->count;
+    return;
+  }
+  if (right != nullptr && right->count > min) {
+    auto *r                   = static_cast<Inner *>(right);
+    c->keys[c->count]         = std::move(node->keys[index]);
+    c->children[c->count + 1] = r->children[0];
+    node->keys[index]         = std::move(r->keys[0]);
+    ++c->count;
+    for (int i = 0; i + 1 < r->count; i++) {
+      r->keys[i] = std::move(r->keys[i + 1]);
+    }
+    for (int i = 0; i < r->count; i++) {
+      r->children[i] = r->children[i + 1];
+    }
+    --r->count;
+    return;
+  }
+  int at  = left != nullptr ? index - 1 : index;
+  auto *l = static_cast<Inner *>(node->children[at]);
+  auto *r = static_cast<Inner *>(node->children[at + 1]);
+  l->keys[l->count] = std::move(node->keys[at]);  // the separator comes down
+  for (int i = 0; i < r->count; i++) {
+    l->keys[l->count + 1 + i] = std::move(r->keys[i]);
+  }
+  for (int i = 0; i <= r->count; i++) {
+    l->children[l->count + 1 + i] = r->children[i];
+  }
+  l->count += 1 + r->count;
+  inners.release(r);
+  for (int i = at; i + 1 < node->count; i++) {
+    node->keys[i]         = std::move(node->keys[i + 1]);
+    node->children[i + 1] = node->children[i + 2];
+  }
+  --node->count;
+}
+// release_tree
+template <typename K, typename V, typename Compare>
+void ForkBTreeMap<K, V, Compare>::release_tree(Node *node, const int &level) {
+  if (level == 0) {
+    leaves.release(static_cast<Leaf *>(node));
+    return;
+  }
+  auto *inner = static_cast<Inner *>(node);
+  for (int i = 0; i <= inner->count; i++) {
+    release_tree(inner->children[i], level - 1);
+  }
+  inners.release(inner);
+}
+// emplace (grows a new root when the old one splits)
+template <typename K, typename V, typename Compare>
+V &ForkBTreeMap<K, V, Compare>::emplace(const K &key, const V &value,
+                                        bool &added) {
+  if (root == nullptr) {
+    root = leaves.acquire();
+  }
+  V *slot     = nullptr;
+  Split split = insert_into(root, height, key, value, slot, added);
+  if (split.right != nullptr) {
+    Inner *top       = inners.acquire();
+    top->keys[0]     = std::move(split.separator);
+    top->children[0] = root;
+    top->children[1] = split.right;
+    top->count       = 1;
+    root             = top;
+    ++height;
+  }
+  if (added) {
+    ++size;
+    stats::elements(1);
+  }
+  return *slot;
+}
+
+// constructor
+template <typename K, typename V, typename Compare>
+ForkBTreeMap<K, V, Compare>::ForkBTreeMap(const Compare &compare)
+    : compare(compare) {}
+// destructor
+template <typename K, typename V, typename Compare>
+ForkBTreeMap<K, V, Compare>::~ForkBTreeMap() {
+  erase();
+}
+// copy constructor (the sorted leaves rebuild a packed tree)
+template <typename K, typename V, typename Compare>
+ForkBTreeMap<K, V, Compare>::ForkBTreeMap(const ForkBTreeMap &other)
+    : compare(other.compare) {
+  ForkVector<std::pair<K, V>> items;
+  items.preAlloc(other.size);
+  for (auto [key, value] : other) {
+    items.push_back(std::pair<K, V>(key, value));
+  }
+  bulk_load(items.GetPtr(), items.GetPtr() + items.GetSize());
+}
+// move constructor
+template <typename K, typename V, typename Compare>
+ForkBTreeMap<K, V, Compare>::ForkBTreeMap(ForkBTreeMap &&other) noexcept
+    : leaves(std::move(other.leaves)),
+      inners(std::move(other.inners)),
+      root(other.root),
+      height(other.height),
+      size(other.size),
+      compare(other.compare) {
+  other.root   = nullptr;
+  other.height = 0;
+  other.size   = 0;
+}
+
+// insert
+template <typename K, typename V, typename Compare>
+bool ForkBTreeMap<K, V, Compare>::insert(const K &key, const V &value) {
+  bool added = false;
+  emplace(key, value, added);
+  return added;
+}
+// insert_or_assign
+template <typename K, typename V, typename Compare>
+void ForkBTreeMap<K, V, Compare>::insert_or_assign(const K &key,
+                                                   const V &value) {
+  bool added = false;
+  V &slot    = emplace(key, value, added);
+  if (!added) {
+    slot = value;
+  }
+}
+// bulk_load (replaces the contents, leaves are packed full)
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+void ForkBTreeMap<K, V, Compare>::bulk_load(InputIt first, InputIt last) {
+  erase();
+  ForkVector<Node *> level;
+  ForkVector<K> least;  // least key under each node of the level
+  Leaf *leaf = nullptr;
+  for (; first != last; ++first) {
+    if (leaf != nullptr &&
+        !compare(leaf->keys[leaf->count - 1], first->first)) {
+      for (int i = 0; i < level.GetSize(); i++) {
+        leaves.release(static_cast<Leaf *>(level[i]));
+      }
+      size = 0;
+      throw std::invalid_argument("bulk_load needs sorted unique keys");
+    }
+    if (leaf == nullptr || leaf->count == slots) {
+      Leaf *fresh = leaves.acquire();
+      fresh->prev = leaf;
+      if (leaf != nullptr) {
+        leaf->next = fresh;
+      }
+      leaf = fresh;
+      level.push_back(leaf);
+      least.push_back(first->first);
+    }
+    leaf->keys[leaf->count]   = first->first;
+    leaf->values[leaf->count] = first->second;
+    ++leaf->count;
+    ++size;
+  }
+  stats::elements(size);
+  if (level.GetSize() == 0) {
+    return;
+  }
+  // an underfull last leaf takes half of the surplus of its left neighbour
+  int n = level.GetSize();
+  if (n > 1 && leaf->count < slots / 2) {
+    auto *left = static_cast<Leaf *>(level[n - 2]);
+    int move   = (left->count - leaf->count) / 2;
+    for (int i = leaf->count - 1; i >= 0; i--) {
+      leaf->keys[i + move]   = std::move(leaf->keys[i]);
+      leaf->values[i + move] = std::move(leaf->values[i]);
+    }
+    for (int i = 0; i < move; i++) {
+      leaf->keys[i]   = std::move(left->keys[left->count - move + i]);
+      leaf->values[i] = std::move(left->values[left->count - move + i]);
+    }
+    left->count -= move;
+    leaf->count += move;
+    least[n - 1] = leaf->keys[0];
+  }
+  // then every level of inner nodes, until one node is left
+  while (level.GetSize() > 1) {
+    ForkVector<Node *> parents;
+    ForkVector<K> parent_least;
+    n     = level.GetSize();
+    int i = 0;
+    while (i < n) {
+      int take = n - i < slots + 1 ? n - i : slots + 1;
+      if (n - i - take > 0 && n - i - take < slots / 2 + 1) {
+        take = (n - i) / 2;  // leave enough children for the last parent
+      }
+      Inner *inner       = inners.acquire();
+      inner->children[0] = level[i];
+      for (int j = 1; j < take; j++) {
+        inner->keys[j - 1] = least[i + j];
+        inner->children[j] = level[i + j];
+      }
+      inner->count = take - 1;
+      parents.push_back(inner);
+      parent_least.push_back(least[i]);
+      i += take;
+    }
+    level = std::move(parents);
+    least = std::move(parent_least);
+    ++height;
+  }
+  root = level[0];
+}
+// erase [key]
+template <typename K, typename V, typename Compare>
+template <typename Q>
+bool ForkBTreeMap<K, V, Compare>::erase(const Q &key) {
+  if (root == nullptr || !erase_from(root, height, key)) {
+    return false;
+  }
+  --size;
+  stats::elements(-1);
+  if (height > 0 && root->count == 0) {  // the root lost its last separator
+    Node *only = static_cast<Inner *>(root)->children[0];
+    inners.release(static_cast<Inner *>(root));
+    root = only;
+    --height;
+  } else if (height == 0 && root->count == 0) {
+    leaves.release(static_cast<Leaf *>(root));
+    root = nullptr;
+  }
+  return true;
+}
+// erase all
+template <typename K, typename V, typename Compare>
+void ForkBTreeMap<K, V, Compare>::erase() {
+  if (root != nullptr) {
+    release_tree(root, height);
+  }
+  stats::elements(-size);
+  root   = nullptr;
+  height = 0;
+  size   = 0;
+}
+// find
+template <typename K, typename V, typename Compare>
+template <typename Q>
+V *ForkBTreeMap<K, V, Compare>::find(const Q &key) {
+  return value_for(key);
+}
+template <typename K, typename V, typename Compare>
+template <typename Q>
+const V *ForkBTreeMap<K, V, Compare>::find(const Q &key) const {
+  return value_for(key);
+}
+// contains
+template <typename K, typename V, typename Compare>
+template <typename Q>
+bool ForkBTreeMap<K, V, Compare>::contains(const Q &key) const {
+  return find(key) != nullptr;
+}
+// get
+template <typename K, typename V, typename Compare>
+template <typename Q>
+V &ForkBTreeMap<K, V, Compare>::get(const Q &key) {
+  V *value = find(key);
+  if (value == nullptr) {
+    throw std::out_of_range("key not found");
+  }
+  return *value;
+}
+template <typename K, typename V, typename Compare>
+template <typename Q>
+const V &ForkBTreeMap<K, V, Compare>::get(const Q &key) const {
+  const V *value = find(key);
+  if (value == nullptr) {
+    throw std::out_of_range("key not found");
+  }
+  return *value;
+}
+// lower_bound
+template <typename K, typename V, typename Compare>
+template <typename Q>
+typename ForkBTreeMap<K, V, Compare>::iterator
+ForkBTreeMap<K, V, Compare>::lower_bound(const Q &key) {
+  Leaf *leaf = leaf_for(key);
+  return leaf == nullptr ? end() : iterator(leaf, lower_index(leaf, key));
+}
+template <typename K, typename V, typename Compare>
+template <typename Q>
+typename ForkBTreeMap<K, V, Compare>::const_iterator
+ForkBTreeMap<K, V, Compare>::lower_bound(const Q &key) const {
+  Leaf *leaf = leaf_for(key);
+  return leaf == nullptr ? end()
+                         : const_iterator(leaf, lower_index(leaf, key));
+}
+// upper_bound
+template <typename K, typename V, typename Compare>
+template <typename Q>
+typename ForkBTreeMap<K, V, Compare>::iterator
+ForkBTreeMap<K, V, Compare>::upper_bound(const Q &key) {
+  Leaf *leaf = leaf_for(key);
+  return leaf == nullptr ? end() : iterator(leaf, upper_index(leaf, key));
+}
+template <typename K, typename V, typename Compare>
+template <typename Q>
+typename ForkBTreeMap<K, V, Compare>::const_iterator
+ForkBTreeMap<K, V, Compare>::upper_bound(const Q &key) const {
+  Leaf *leaf = leaf_for(key);
+  return leaf == nullptr ? end()
+                         : const_iterator(leaf, upper_index(leaf, key));
+}
+// get_size
+template <typename K, typename V, typename Compare>
+int ForkBTreeMap<K, V, Compare>::get_size() const {
+  return size;
+}
+// get_height
+template <typename K, typename V, typename Compare>
+int ForkBTreeMap<K, V, Compare>::get_height() const {
+  return height;
+}
+// is_empty
+template <typename K, typename V, typename Compare>
+bool ForkBTreeMap<K, V, Compare>::is_empty() const {
+  return size == 0;
+}
+
+// operator []
+template <typename K, typename V, typename Compare>
+V &ForkBTreeMap<K, V, Compare>::operator[](const K &key) {
+  bool added = false;
+  return emplace(key, V(), added);
+}
+// copy assignment
+template <typename K, typename V, typename Compare>
+ForkBTreeMap<K, V, Compare> &ForkBTreeMap<K, V, Compare>::operator=(
+    const ForkBTreeMap &other) {
+  if (this == &other) {
+    return *this;
+  }
+  ForkBTreeMap copy(other);
+  *this = std::move(copy);
+  return *this;
+}
+// move assignment
+template <typename K, typename V, typename Compare>
+ForkBTreeMap<K, V, Compare> &ForkBTreeMap<K, V, Compare>::operator=(
+    ForkBTreeMap &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  erase();
+  std::swap(leaves, other.leaves);
+  std::swap(inners, other.inners);
+  std::swap(root, other.root);
+  std::swap(height, other.height);
+  std::swap(size, other.size);
+  compare = other.compare;
+  return *this;
+}
+
+// echo
+template <typename K, typename V, typename Compare>
+void ForkBTreeMap<K, V, Compare>::echo() const {
+  std::cout << "current btree map: ";
+  for (auto [key, value] : *this) {
+    std::cout << key << ": " << value << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
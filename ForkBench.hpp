@@ -0,0 +1,130 @@
+// micro-benchmark harness used by ForkSTL_bench
+// every measurement prints one CSV row:
+//   library,container,operation,element,n,ops,ns_per_op
+// ns_per_op is the best repetition divided by ops, setup is never timed
+// in perf mode every row also gets the hardware counters of that best
+// repetition per op (see ForkPerfCounters.hpp), empty when unavailable
+
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "ForkPerfCounters.hpp"
+
+class ForkBench {
+private:
+  std::ostream &out;
+  std::string filter;  // run only rows whose "container/operation" has it
+  int repetitions;     // best of this many runs is reported
+  std::unique_ptr<ForkPerfCounters> counters;  // null unless in perf mode
+
+public:
+  explicit ForkBench(std::ostream &out = std::cout,
+                     const std::string &filter = "",
+                     const int &repetitions = 5, const bool &perf = false);
+
+  void header() const;  // print the CSV header line
+  [[nodiscard]] bool enabled(const std::string &container,
+                             const std::string &operation) const;
+
+  // setup() builds a fresh state for each repetition, body(state) is timed
+  template <typename Setup, typename Body>
+  void run(const std::string &library, const std::string &container,
+           const std::string &operation, const std::string &element,
+           const int &n, const long long &ops, Setup setup, Body body);
+
+  // keep a value alive so the optimizer cannot drop the work producing it
+  template <typename V>
+  static void keep(const V &value);
+};
+
+// constructor
+inline ForkBench::ForkBench(std::ostream &out, const std::string &filter,
+                            const int &repetitions, const bool &perf)
+    : out(out), filter(filter), repetitions(repetitions) {
+  if (this->repetitions < 1) {
+    this->repetitions = 1;
+  }
+  if (perf) {
+    counters = std::make_unique<ForkPerfCounters>();
+    if (!counters->available()) {
+      std::cerr << "# perf_event_open failed, counter columns stay empty"
+                << std::endl;
+    }
+  }
+}
+// header
+inline void ForkBench::header() const {
+  out << "library,container,operation,element,n,ops,ns_per_op";
+  if (counters) {
+    for (const char *name : ForkPerfCounters::names) {
+      out << "," << name << "_per_op";
+    }
+  }
+  out << std::endl;
+}
+// enabled
+inline bool ForkBench::enabled(const std::string &container,
+                               const std::string &operation) const {
+  if (filter.empty()) {
+    return true;
+  }
+  return (container + "/" + operation).find(filter) != std::string::npos;
+}
+// run
+template <typename Setup, typename Body>
+void ForkBench::run(const std::string &library, const std::string &container,
+                    const std::string &operation, const std::string &element,
+                    const int &n, const long long &ops, Setup setup,
+                    Body body) {
+  if (!enabled(container, operation)) {
+    return;
+  }
+  double best = std::numeric_limits<double>::max();
+  long long best_events[ForkPerfCounters::count];
+  long long events[ForkPerfCounters::count];
+  for (int rep = 0; rep < repetitions; rep++) {
+    auto state = setup();
+    if (counters) {
+      counters->start();
+    }
+    auto start = std::chrono::steady_clock::now();
+    body(state);
+    auto stop = std::chrono::steady_clock::now();
+    if (counters) {
+      counters->stop(events);
+    }
+    keep(state);
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    if (ns < best) {
+      best = ns;
+      for (int i = 0; counters && i < ForkPerfCounters::count; i++) {
+        best_events[i] = events[i];
+      }
+    }
+  }
+  double per = static_cast<double>(ops > 0 ? ops : 1);
+  out << library << "," << container << "," << operation << "," << element
+      << "," << n << "," << ops << "," << best / per;
+  for (int i = 0; counters && i < ForkPerfCounters::count; i++) {
+    out << ",";
+    if (best_events[i] >= 0) {
+      out << static_cast<double>(best_events[i]) / per;
+    }
+  }
+  out << std::endl;
+}
+// keep
+template <typename V>
+void ForkBench::keep(const V &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const volatile void *sink;
+  sink = &value;
+#endif
+}
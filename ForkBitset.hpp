@@ -0,0 +1,518 @@
+// packed dynamic bitset, 64 flags per word
+// also serves as ForkVector<bool> (specialized at the bottom), which keeps
+// the ForkVector interface but hands out proxy references instead of bool&
+//
+// count() is a popcount per word, GetIndex() / find_next() skip whole
+// words and locate the bit with a count-trailing-zeros (tzcnt), and the
+// bitwise operators combine two sets one word at a time. bits past size
+// in the last word are always zero
+
+/*
+ *  word 0: [ bit 63 ... bit 0 ]  word 1: [ bit 127 ... bit 64 ] ...
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include "ForkExport.hpp"
+#include "ForkStats.hpp"
+#include "ForkStorage.hpp"  // declares ForkVector
+
+class ForkBitset {
+public:
+  using value_type                   = bool;
+  using word_type                    = std::uint64_t;
+  static constexpr int bits_per_word = 64;
+
+private:
+  using stats = ForkStatsOf<ForkBitset>;  // no-op unless FORK_STL_STATS
+
+  word_type *words = nullptr;  // packed flags
+  int size         = 0;        // num of flags in use
+  int capacity     = 0;        // num of flags allocated, multiple of 64
+
+  static constexpr int word_count(const int &bits);
+  constexpr void trim();  // zero the bits past size in the last word
+  constexpr void check_same_size(const ForkBitset &other) const;
+
+public:
+  // proxy for one flag, returned by operator[] and GetElement
+  class reference {
+  private:
+    word_type *word;
+    word_type mask;
+
+  public:
+    constexpr reference(word_type *word, const int &bit)
+        : word(word), mask(word_type(1) << bit) {}
+    constexpr operator bool() const { return (*word & mask) != 0; }
+    constexpr reference &operator=(const bool &value) {
+      *word = value ? (*word | mask) : (*word & ~mask);
+      return *this;
+    }
+    constexpr reference &operator=(const reference &other) {
+      return *this = static_cast<bool>(other);
+    }
+    constexpr void flip() { *word ^= mask; }
+  };
+
+  // constructor and destructor
+  constexpr ForkBitset() = default;
+  constexpr explicit ForkBitset(const int &n, const bool &value = false);
+  constexpr ~ForkBitset();
+  constexpr ForkBitset(const ForkBitset &other);
+  constexpr ForkBitset(ForkBitset &&other) noexcept;
+
+  // functions
+  constexpr void preAlloc(const int &n);  // capacity in flags
+  constexpr void resize(const int &n, const bool &value = false);
+  constexpr void push_back(const bool &value);
+  constexpr void pop_back();
+  constexpr void clear(const int &index);  // remove one flag, keep capacity
+  constexpr void clear();                  // remove all, keep capacity
+  constexpr void erase(const int &index);  // remove one flag, shrink
+  constexpr void erase();                  // remove all, release memory
+  constexpr void shrink_to_fit();
+  [[nodiscard]] constexpr int GetSize() const;
+  [[nodiscard]] constexpr int GetCapacity() const;
+  constexpr word_type *GetPtr() const;  // the packed words
+  constexpr reference GetElement(const int &index);
+  constexpr void SetElement(const int &index, const bool &value);
+  [[nodiscard]] constexpr int GetIndex(const bool &value) const;  // or -1
+  constexpr void ResetAll(const bool &value);
+
+  // bit operations
+  [[nodiscard]] constexpr int count() const;  // num of set flags
+  [[nodiscard]] constexpr int find_next(const int &from,
+                                        const bool &value = true) const;
+  constexpr void flip();  // invert every flag
+  [[nodiscard]] constexpr bool any() const;
+  [[nodiscard]] constexpr bool none() const;
+
+  // operator overloading
+  constexpr reference operator[](const int &index);
+  constexpr bool operator[](const int &index) const;
+  constexpr ForkBitset &operator=(const ForkBitset &other);
+  constexpr ForkBitset &operator=(ForkBitset &&other) noexcept;
+  constexpr ForkBitset &operator&=(const ForkBitset &other);  // same size
+  constexpr ForkBitset &operator|=(const ForkBitset &other);  // same size
+  constexpr ForkBitset &operator^=(const ForkBitset &other);  // same size
+  constexpr ForkBitset operator&(const ForkBitset &other) const;
+  constexpr ForkBitset operator|(const ForkBitset &other) const;
+  constexpr ForkBitset operator^(const ForkBitset &other) const;
+  constexpr ForkBitset operator~() const;
+  constexpr bool operator==(const ForkBitset &other) const;
+  constexpr bool operator!=(const ForkBitset &other) const;
+
+  // echo and export
+  void echo() const;
+  void export_to(ForkExport &out) const;
+};
+
+// ForkVector<bool> is the packed bitset
+template <>
+class ForkVector<bool> : public ForkBitset {
+public:
+  using ForkBitset::ForkBitset;
+  constexpr ForkVector() = default;
+  // results of the bitwise operators convert back implicitly
+  constexpr ForkVector(ForkBitset &&other) noexcept
+      : ForkBitset(static_cast<ForkBitset &&>(other)) {}
+};
+
+// word_count
+constexpr int ForkBitset::word_count(const int &bits) {
+  return (bits + bits_per_word - 1) / bits_per_word;
+}
+// trim
+constexpr void ForkBitset::trim() {
+  if (size % bits_per_word != 0) {
+    words[size / bits_per_word] &= (word_type(1) << size % bits_per_word) - 1;
+  }
+}
+// check_same_size
+constexpr void ForkBitset::check_same_size(const ForkBitset &other) const {
+  if (size != other.size) {
+    throw std::invalid_argument("bitsets differ in size");
+  }
+}
+
+// constructor (n copies of value)
+constexpr ForkBitset::ForkBitset(const int &n, const bool &value) {
+  resize(n, value);
+}
+// destructor
+constexpr ForkBitset::~ForkBitset() {
+  if (words != nullptr) {
+    stats::release(word_count(capacity) * sizeof(word_type));
+    stats::elements(-size);
+  }
+  delete[] words;
+}
+// copy constructor
+constexpr ForkBitset::ForkBitset(const ForkBitset &other) {
+  if (other.size == 0) {
+    return;
+  }
+  preAlloc(other.size);
+  for (int i = 0; i < word_count(other.size); i++) {
+    words[i] = other.words[i];
+  }
+  size = other.size;
+  stats::elements(size);
+}
+// move constructor
+constexpr ForkBitset::ForkBitset(ForkBitset &&other) noexcept {
+  words          = other.words;
+  size           = other.size;
+  capacity       = other.capacity;
+  other.words    = nullptr;
+  other.size     = 0;
+  other.capacity = 0;
+}
+
+// pre_allocate_capacity (new words start zeroed)
+constexpr void ForkBitset::preAlloc(const int &n) {
+  if (n <= capacity) {
+    return;
+  }
+  int old_words   = word_count(capacity);
+  int new_words   = word_count(n);
+  word_type *temp = new word_type[new_words]();
+  for (int i = 0; i < old_words; i++) {
+    temp[i] = words[i];
+  }
+  if (words != nullptr) {
+    stats::reallocate(old_words * sizeof(word_type),
+                      new_words * sizeof(word_type),
+                      old_words * sizeof(word_type));
+  } else {
+    stats::allocate(new_words * sizeof(word_type));
+  }
+  delete[] words;
+  words    = temp;
+  capacity = new_words * bits_per_word;
+  stats::shape(size, capacity);
+}
+// resize
+constexpr void ForkBitset::resize(const int &n, const bool &value) {
+  if (n < 0) {
+    throw std::out_of_range("index out of range");
+  }
+  if (n > capacity) {
+    preAlloc(n);
+  }
+  if (n > size && value) {
+    // fill the tail of the partial word, then whole words
+    int i = size;
+    for (; i < n && i % bits_per_word != 0; i++) {
+      words[i / bits_per_word] |= word_type(1) << i % bits_per_word;
+    }
+    for (; i < n; i += bits_per_word) {
+      words[i / bits_per_word] = ~word_type(0);
+    }
+  }
+  if (n < size) {
+    // zero every word past the new end so the invariant holds
+    for (int w = word_count(n); w < word_count(size); w++) {
+      words[w] = 0;
+    }
+  }
+  stats::elements(n - size);
+  size = n;
+  if (words != nullptr) {
+    trim();
+  }
+  stats::shape(size, capacity);
+}
+// push_back
+constexpr void ForkBitset::push_back(const bool &value) {
+  if (size == capacity) {
+    preAlloc(capacity > 0 ? capacity * 2 : bits_per_word);
+  }
+  if (value) {
+    words[size / bits_per_word] |= word_type(1) << size % bits_per_word;
+  }
+  ++size;
+  stats::elements(1);
+  stats::shape(size, capacity);
+}
+// pop_back
+constexpr void ForkBitset::pop_back() {
+  if (size > 0) {
+    --size;
+    words[size / bits_per_word] &= ~(word_type(1) << size % bits_per_word);
+    stats::elements(-1);
+  }
+}
+// clear [index] (later flags move down by one, word by word)
+constexpr void ForkBitset::clear(const int &index) {
+  if (index < 0 || index >= size) {
+    return;
+  }
+  int w           = index / bits_per_word;
+  int last        = word_count(size) - 1;
+  word_type below = (word_type(1) << index % bits_per_word) - 1;
+  word_type above = ~below << 1;  // drops the removed bit
+  words[w]        = (words[w] & below) | ((words[w] & above) >> 1);
+  for (; w < last; w++) {
+    words[w] |= words[w + 1] << (bits_per_word - 1);
+    words[w + 1] >>= 1;
+  }
+  --size;
+  stats::elements(-1);
+}
+// clear all
+constexpr void ForkBitset::clear() {
+  for (int i = 0; i < word_count(size); i++) {
+    words[i] = 0;
+  }
+  stats::elements(-size);
+  size = 0;
+}
+// erase [index]
+constexpr void ForkBitset::erase(const int &index) {
+  clear(index);
+  shrink_to_fit();
+}
+// erase all
+constexpr void ForkBitset::erase() {
+  clear();
+  shrink_to_fit();
+}
+// shrink_to_fit
+constexpr void ForkBitset::shrink_to_fit() {
+  int used_words = word_count(size);
+  if (used_words == word_count(capacity)) {
+    return;
+  }
+  word_type *temp = nullptr;
+  if (used_words > 0) {
+    temp = new word_type[used_words];
+    for (int i = 0; i < used_words; i++) {
+      temp[i] = words[i];
+    }
+  }
+  stats::reallocate(word_count(capacity) * sizeof(word_type),
+                    used_words * sizeof(word_type),
+                    used_words * sizeof(word_type));
+  delete[] words;
+  words    = temp;
+  capacity = used_words * bits_per_word;
+}
+// get_size
+constexpr int ForkBitset::GetSize() const {
+  return size;
+}
+// get_capacity
+constexpr int ForkBitset::GetCapacity() const {
+  return capacity;
+}
+// get the packed words
+constexpr ForkBitset::word_type *ForkBitset::GetPtr() const {
+  return words;
+}
+// get_element
+constexpr ForkBitset::reference ForkBitset::GetElement(const int &index) {
+  return (*this)[index];
+}
+// set_element
+constexpr void ForkBitset::SetElement(const int &index, const bool &value) {
+  (*this)[index] = value;
+}
+// get_index
+constexpr int ForkBitset::GetIndex(const bool &value) const {
+  return find_next(0, value);
+}
+// ResetAll
+constexpr void ForkBitset::ResetAll(const bool &value) {
+  for (int i = 0; i < word_count(size); i++) {
+    words[i] = value ? ~word_type(0) : 0;
+  }
+  if (size > 0) {
+    trim();
+  }
+}
+
+// count
+constexpr int ForkBitset::count() const {
+  int total = 0;
+  for (int i = 0; i < word_count(size); i++) {
+    total += std::popcount(words[i]);
+  }
+  return total;
+}
+// find_next (first flag equal to value at or after from, or -1)
+constexpr int ForkBitset::find_next(const int &from, const bool &value) const {
+  if (from < 0 || from >= size) {
+    return -1;
+  }
+  int w          = from / bits_per_word;
+  word_type bits = value ? words[w] : ~words[w];
+  bits &= ~word_type(0) << from % bits_per_word;
+  int steps = 1;
+  while (bits == 0) {
+    if (++w >= word_count(size)) {
+      stats::walk(steps);
+      return -1;
+    }
+    bits = value ? words[w] : ~words[w];
+    ++steps;
+  }
+  stats::walk(steps);
+  int found = w * bits_per_word + std::countr_zero(bits);
+  return found < size ? found : -1;  // ~0 past size when value is false
+}
+// flip
+constexpr void ForkBitset::flip() {
+  for (int i = 0; i < word_count(size); i++) {
+    words[i] = ~words[i];
+  }
+  if (size > 0) {
+    trim();
+  }
+}
+// any
+constexpr bool ForkBitset::any() const {
+  for (int i = 0; i < word_count(size); i++) {
+    if (words[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+// none
+constexpr bool ForkBitset::none() const {
+  return !any();
+}
+
+// operator []
+constexpr ForkBitset::reference ForkBitset::operator[](const int &index) {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return reference(words + index / bits_per_word, index % bits_per_word);
+}
+constexpr bool ForkBitset::operator[](const int &index) const {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return (words[index / bits_per_word] >> index % bits_per_word & 1) != 0;
+}
+// copy assignment
+constexpr ForkBitset &ForkBitset::operator=(const ForkBitset &other) {
+  if (this == &other) {
+    return *this;
+  }
+  clear();
+  preAlloc(other.size);
+  for (int i = 0; i < word_count(other.size); i++) {
+    words[i] = other.words[i];
+  }
+  size = other.size;
+  stats::elements(size);
+  return *this;
+}
+// move assignment
+constexpr ForkBitset &ForkBitset::operator=(ForkBitset &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (words != nullptr) {
+    stats::release(word_count(capacity) * sizeof(word_type));
+    stats::elements(-size);
+  }
+  delete[] words;
+  words          = other.words;
+  size           = other.size;
+  capacity       = other.capacity;
+  other.words    = nullptr;
+  other.size     = 0;
+  other.capacity = 0;
+  return *this;
+}
+// operator &=
+constexpr ForkBitset &ForkBitset::operator&=(const ForkBitset &other) {
+  check_same_size(other);
+  for (int i = 0; i < word_count(size); i++) {
+    words[i] &= other.words[i];
+  }
+  return *this;
+}
+// operator |=
+constexpr ForkBitset &ForkBitset::operator|=(const ForkBitset &other) {
+  check_same_size(other);
+  for (int i = 0; i < word_count(size); i++) {
+    words[i] |= other.words[i];
+  }
+  return *this;
+}
+// operator ^=
+constexpr ForkBitset &ForkBitset::operator^=(const ForkBitset &other) {
+  check_same_size(other);
+  for (int i = 0; i < word_count(size); i++) {
+    words[i] ^= other.words[i];
+  }
+  return *this;
+}
+// operator &
+constexpr ForkBitset ForkBitset::operator&(const ForkBitset &other) const {
+  ForkBitset result(*this);
+  result &= other;
+  return result;
+}
+// operator |
+constexpr ForkBitset ForkBitset::operator|(const ForkBitset &other) const {
+  ForkBitset result(*this);
+  result |= other;
+  return result;
+}
+// operator ^
+constexpr ForkBitset ForkBitset::operator^(const ForkBitset &other) const {
+  ForkBitset result(*this);
+  result ^= other;
+  return result;
+}
+// operator ~
+constexpr ForkBitset ForkBitset::operator~() const {
+  ForkBitset result(*this);
+  result.flip();
+  return result;
+}
+// operator ==
+constexpr bool ForkBitset::operator==(const ForkBitset &other) const {
+  if (size != other.size) {
+    return false;
+  }
+  for (int i = 0; i < word_count(size); i++) {
+    if (words[i] != other.words[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+// operator !=
+constexpr bool ForkBitset::operator!=(const ForkBitset &other) const {
+  return !(*this == other);
+}
+
+// echo
+inline void ForkBitset::echo() const {
+  std::cout << "current bitset: ";
+  for (int i = 0; i < size; i++) {
+    std::cout << (*this)[i];
+  }
+  std::cout << " (" << count() << " set)" << std::endl;
+  std::cout << std::endl;
+}
+// export_to
+inline void ForkBitset::export_to(ForkExport &out) const {
+  for (int i = 0; i < size; i++) {
+    out.add((*this)[i]);
+  }
+  out.end_record();
+}
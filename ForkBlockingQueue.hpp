@@ -0,0 +1,253 @@
+// a thread-safe ForkQueue
+// consumers sleep instead of polling get_size()
+// producers sleep when the queue is full (capacity > 0)
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkQueue.hpp"
+#include "ForkVector.hpp"
+
+template <typename T>
+class ForkBlockingQueue {
+private:
+  ForkQueue<T> queue;                 // storage, guarded by mtx
+  int capacity          = 0;          // max num of elements (0 = unbounded)
+  bool closed           = false;      // no more push() after close()
+  int waiting_consumers = 0;          // threads sleeping in pop()
+  int waiting_producers = 0;          // threads sleeping in push()
+  mutable std::mutex mtx;             // guards all of the above
+  std::condition_variable not_empty;  // signalled after push
+  std::condition_variable not_full;   // signalled after pop
+
+  T take_head();  // pop one element, lock held
+  void wake_consumer(std::unique_lock<std::mutex> &lock);
+  void wake_producers(std::unique_lock<std::mutex> &lock, const int &freed);
+
+public:
+  // constructor and destructor
+  explicit ForkBlockingQueue(const int &capacity = 0);
+  ~ForkBlockingQueue() = default;
+  ForkBlockingQueue(const ForkBlockingQueue &other)            = delete;
+  ForkBlockingQueue &operator=(const ForkBlockingQueue &other) = delete;
+
+  // producer side
+  void push(const T &data);      // block while full
+  bool try_push(const T &data);  // false if full or closed
+  template <typename Rep, typename Period>
+  bool push_for(const T &data,
+                const std::chrono::duration<Rep, Period> &timeout);
+
+  // consumer side
+  T pop();               // block while empty
+  bool try_pop(T &out);  // false if empty
+  template <typename Rep, typename Period>
+  bool pop_for(T &out, const std::chrono::duration<Rep, Period> &timeout);
+  int drain_into(ForkVector<T> &out, const int &max = 0);  // batch pop
+  int try_drain_into(ForkVector<T> &out, const int &max = 0);
+
+  // state
+  void close();  // wake everyone, refuse further push()
+  [[nodiscard]] bool is_closed() const;
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] int get_capacity() const;
+};
+
+// constructor
+template <typename T>
+ForkBlockingQueue<T>::ForkBlockingQueue(const int &capacity) {
+  this->capacity = capacity > 0 ? capacity : 0;
+}
+
+// take_head (lock held, queue not empty)
+template <typename T>
+T ForkBlockingQueue<T>::take_head() {
+  T data = std::move(queue.data_head()->data);
+  queue.quit_head();
+  return data;
+}
+// wake_consumer (only pay for a notify when someone is actually asleep)
+template <typename T>
+void ForkBlockingQueue<T>::wake_consumer(std::unique_lock<std::mutex> &lock) {
+  bool need_notify = waiting_consumers > 0;
+  lock.unlock();
+  if (need_notify) {
+    not_empty.notify_one();
+  }
+}
+// wake_producers
+template <typename T>
+void ForkBlockingQueue<T>::wake_producers(std::unique_lock<std::mutex> &lock,
+                                          const int &freed) {
+  bool need_notify = waiting_producers > 0 && freed > 0;
+  lock.unlock();
+  if (!need_notify) {
+    return;
+  }
+  if (freed == 1) {
+    not_full.notify_one();
+  } else {
+    not_full.notify_all();
+  }
+}
+
+// push
+template <typename T>
+void ForkBlockingQueue<T>::push(const T &data) {
+  std::unique_lock<std::mutex> lock(mtx);
+  if (capacity > 0) {
+    ++waiting_producers;
+    not_full.wait(lock,
+                  [this] { return closed || queue.get_size() < capacity; });
+    --waiting_producers;
+  }
+  if (closed) {
+    throw std::out_of_range("queue is closed");
+  }
+  queue.push(data);
+  wake_consumer(lock);
+}
+// try_push
+template <typename T>
+bool ForkBlockingQueue<T>::try_push(const T &data) {
+  std::unique_lock<std::mutex> lock(mtx);
+  if (closed || (capacity > 0 && queue.get_size() >= capacity)) {
+    return false;
+  }
+  queue.push(data);
+  wake_consumer(lock);
+  return true;
+}
+// push_for
+template <typename T>
+template <typename Rep, typename Period>
+bool ForkBlockingQueue<T>::push_for(
+    const T &data, const std::chrono::duration<Rep, Period> &timeout) {
+  std::unique_lock<std::mutex> lock(mtx);
+  if (capacity > 0) {
+    ++waiting_producers;
+    bool ready = not_full.wait_for(lock, timeout, [this] {
+      return closed || queue.get_size() < capacity;
+    });
+    --waiting_producers;
+    if (!ready) {
+      return false;
+    }
+  }
+  if (closed) {
+    return false;
+  }
+  queue.push(data);
+  wake_consumer(lock);
+  return true;
+}
+
+// pop
+template <typename T>
+T ForkBlockingQueue<T>::pop() {
+  std::unique_lock<std::mutex> lock(mtx);
+  ++waiting_consumers;
+  not_empty.wait(lock, [this] { return closed || queue.get_size() > 0; });
+  --waiting_consumers;
+  if (queue.get_size() == 0) {
+    throw std::out_of_range("queue is closed");
+  }
+  T data = take_head();
+  wake_producers(lock, 1);
+  return data;
+}
+// try_pop
+template <typename T>
+bool ForkBlockingQueue<T>::try_pop(T &out) {
+  std::unique_lock<std::mutex> lock(mtx);
+  if (queue.get_size() == 0) {
+    return false;
+  }
+  out = take_head();
+  wake_producers(lock, 1);
+  return true;
+}
+// pop_for
+template <typename T>
+template <typename Rep, typename Period>
+bool ForkBlockingQueue<T>::pop_for(
+    T &out, const std::chrono::duration<Rep, Period> &timeout) {
+  std::unique_lock<std::mutex> lock(mtx);
+  ++waiting_consumers;
+  bool ready = not_empty.wait_for(
+      lock, timeout, [this] { return closed || queue.get_size() > 0; });
+  --waiting_consumers;
+  if (!ready || queue.get_size() == 0) {
+    return false;
+  }
+  out = take_head();
+  wake_producers(lock, 1);
+  return true;
+}
+// drain_into (block until non-empty, then take up to max in one lock)
+// max <= 0 means take everything; returns num of elements moved (0 = closed)
+template <typename T>
+int ForkBlockingQueue<T>::drain_into(ForkVector<T> &out, const int &max) {
+  std::unique_lock<std::mutex> lock(mtx);
+  ++waiting_consumers;
+  not_empty.wait(lock, [this] { return closed || queue.get_size() > 0; });
+  --waiting_consumers;
+  int n = queue.get_size();
+  if (max > 0 && max < n) {
+    n = max;
+  }
+  out.preAlloc(out.GetSize() + n);
+  for (int i = 0; i < n; i++) {
+    out.push_back(take_head());
+  }
+  wake_producers(lock, n);
+  return n;
+}
+// try_drain_into (never blocks)
+template <typename T>
+int ForkBlockingQueue<T>::try_drain_into(ForkVector<T> &out, const int &max) {
+  std::unique_lock<std::mutex> lock(mtx);
+  int n = queue.get_size();
+  if (max > 0 && max < n) {
+    n = max;
+  }
+  out.preAlloc(out.GetSize() + n);
+  for (int i = 0; i < n; i++) {
+    out.push_back(take_head());
+  }
+  wake_producers(lock, n);
+  return n;
+}
+
+// close
+template <typename T>
+void ForkBlockingQueue<T>::close() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    closed = true;
+  }
+  not_empty.notify_all();
+  not_full.notify_all();
+}
+// is_closed
+template <typename T>
+bool ForkBlockingQueue<T>::is_closed() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return closed;
+}
+// get_size
+template <typename T>
+int ForkBlockingQueue<T>::get_size() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return queue.get_size();
+}
+// get_capacity
+template <typename T>
+int ForkBlockingQueue<T>::get_capacity() const {
+  return capacity;
+}
@@ -0,0 +1,148 @@
+// a detached run of doubly linked nodes, handed between ForkList, ForkQueue
+// and ForkStack without allocating a node or copying a payload:
+//   ForkList<Job> batch;
+//   ...
+//   ForkQueue<Job> work(std::move(batch));    // O(1), the nodes move over
+//   work.splice_back(more.release_chain());   // append a whole batch, O(1)
+//   ForkStack<Job> undo(std::move(work));     // and on again
+//
+// all three link the same ForkChainNode, next runs from the head of the
+// list / queue and from the surface of the stack, so the order survives:
+// whatever a list holds at its head is fetched or popped first
+//
+// a chain nobody takes frees its nodes; the receiving container starts
+// without a value index (enable_index / EnableIndex builds one), and a
+// splice into an indexed container walks the batch to index it
+
+/*
+ *  ForkList    head    -(next)-> ... -(next)-> tail
+ *  ForkQueue   head    -(next)-> ... -(next)-> tail     fetch_head() first
+ *  ForkStack   surface -(next)-> ... -(next)-> bottom   pop() first
+ */
+
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+
+#include "ForkStats.hpp"
+
+template <typename T>
+class ForkChainNode {
+public:
+  T data;
+  ForkChainNode *next = nullptr;
+  ForkChainNode *prev = nullptr;
+  ForkChainNode()     = default;
+  explicit ForkChainNode(const T &data) : data(data) {}
+};
+
+template <typename T>
+class ForkChain {
+public:
+  using value_type = T;
+  using Node       = ForkChainNode<T>;
+
+private:
+  using stats = ForkStatsOf<ForkChain>;  // no-op unless FORK_STL_STATS
+
+  Node *head = nullptr;
+  Node *tail = nullptr;
+  int size   = 0;
+
+public:
+  // constructor and destructor
+  ForkChain() = default;
+  ForkChain(Node *head, Node *tail, const int &size);  // takes the nodes
+  ~ForkChain();                                        // frees untaken nodes
+  ForkChain(const ForkChain &other) = delete;
+  ForkChain(ForkChain &&other) noexcept;
+
+  // functions
+  Node *data_head() const;  // get the head_ptr
+  Node *data_tail() const;  // get the tail_ptr
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] bool is_empty() const;
+  void release();  // the nodes now belong to the caller, the chain is empty
+
+  // operator overloading
+  ForkChain &operator=(const ForkChain &other) = delete;
+  ForkChain &operator=(ForkChain &&other) noexcept;
+};
+
+// a container that can give its nodes away as a ForkChain<T>, only an
+// rvalue qualifies, so an lvalue still picks the copy constructor
+template <typename Source, typename T>
+concept ForkChainSource =
+    !std::is_reference_v<Source> && requires(Source &from) {
+      { from.release_chain() } -> std::same_as<ForkChain<T>>;
+    };
+
+// constructor and destructor
+template <typename T>
+ForkChain<T>::ForkChain(Node *head, Node *tail, const int &size)
+    : head(head), tail(tail), size(size) {
+  stats::adopt(size * static_cast<long long>(sizeof(Node)), size);
+  stats::shape(size, size);
+}
+template <typename T>
+ForkChain<T>::~ForkChain() {
+  Node *curr = head;
+  while (curr != nullptr) {
+    Node *temp = curr;
+    curr       = curr->next;
+    delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
+  }
+}
+template <typename T>
+ForkChain<T>::ForkChain(ForkChain &&other) noexcept {
+  head       = other.head;
+  tail       = other.tail;
+  size       = other.size;
+  other.head = nullptr;
+  other.tail = nullptr;
+  other.size = 0;
+}
+
+// functions
+template <typename T>
+typename ForkChain<T>::Node *ForkChain<T>::data_head() const {
+  return head;
+}
+template <typename T>
+typename ForkChain<T>::Node *ForkChain<T>::data_tail() const {
+  return tail;
+}
+template <typename T>
+int ForkChain<T>::get_size() const {
+  return size;
+}
+template <typename T>
+bool ForkChain<T>::is_empty() const {
+  return size == 0;
+}
+template <typename T>
+void ForkChain<T>::release() {
+  stats::adopt(-size * static_cast<long long>(sizeof(Node)), -size);
+  head = nullptr;
+  tail = nullptr;
+  size = 0;
+}
+
+// operator overloading
+template <typename T>
+ForkChain<T> &ForkChain<T>::operator=(ForkChain &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  ForkChain dropped(std::move(*this));  // frees the nodes held so far
+  head       = other.head;
+  tail       = other.tail;
+  size       = other.size;
+  other.head = nullptr;
+  other.tail = nullptr;
+  other.size = 0;
+  return *this;
+}
@@ -0,0 +1,264 @@
+// awaitable channel over ForkQueue storage (C++20 coroutines)
+// co_await chan.push(v) suspends while the buffer is full
+// co_await chan.pop() suspends while the buffer is empty
+// suspended coroutines are resumed through the channel's executor, so any
+// number of logical consumers can share a handful of threads
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "ForkQueue.hpp"
+
+template <typename T>
+class ForkChannel {
+public:
+  // decides where a resumed coroutine runs (default: inline, on the thread
+  // that made it runnable)
+  using Executor = std::function<void(std::coroutine_handle<>)>;
+
+  class PushAwaiter;
+  class PopAwaiter;
+
+private:
+  ForkQueue<T> buffer;                    // buffered values
+  ForkQueue<PushAwaiter *> blocked_push;  // producers waiting for room
+  ForkQueue<PopAwaiter *> blocked_pop;    // consumers waiting for a value
+  int capacity = 0;                       // max buffered (0 = unbounded)
+  bool closed  = false;
+  Executor executor;
+  std::mutex mtx;
+
+  template <typename U>
+  static U take_head(ForkQueue<U> &waiters);
+  void resume(std::coroutine_handle<> handle);
+
+public:
+  // co_await push(v) -> bool (false if the channel was closed)
+  class PushAwaiter {
+  private:
+    ForkChannel &channel;
+    T value;
+    bool accepted = false;
+    std::coroutine_handle<> handle;
+    friend class ForkChannel;
+
+  public:
+    PushAwaiter(ForkChannel &channel, T value)
+        : channel(channel), value(std::move(value)) {}
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle);
+    bool await_resume() const noexcept { return accepted; }
+  };
+
+  // co_await pop() -> std::optional<T> (empty once closed and drained)
+  class PopAwaiter {
+  private:
+    ForkChannel &channel;
+    std::optional<T> value;
+    std::coroutine_handle<> handle;
+    friend class ForkChannel;
+
+  public:
+    explicit PopAwaiter(ForkChannel &channel) : channel(channel) {}
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle);
+    std::optional<T> await_resume() { return std::move(value); }
+  };
+
+  // constructor and destructor
+  explicit ForkChannel(const int &capacity = 0, Executor executor = nullptr);
+  ~ForkChannel() = default;
+  ForkChannel(const ForkChannel &other)            = delete;
+  ForkChannel &operator=(const ForkChannel &other) = delete;
+
+  // functions
+  PushAwaiter push(T value);  // co_await it
+  PopAwaiter pop();           // co_await it
+  bool try_push(const T &value);
+  std::optional<T> try_pop();
+  void close();  // fail blocked pushes, pops fail once drained
+  [[nodiscard]] bool is_closed();
+  [[nodiscard]] int get_size();
+  [[nodiscard]] int get_capacity() const;
+};
+
+// fire-and-forget coroutine, handy for channel producers and consumers
+class ForkDetached {
+public:
+  class promise_type {
+  public:
+    ForkDetached get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+// constructor
+template <typename T>
+ForkChannel<T>::ForkChannel(const int &capacity, Executor executor)
+    : executor(std::move(executor)) {
+  this->capacity = capacity > 0 ? capacity : 0;
+}
+
+// take_head (lock held, waiters not empty)
+template <typename T>
+template <typename U>
+U ForkChannel<T>::take_head(ForkQueue<U> &waiters) {
+  U waiter = waiters.data_head()->data;
+  waiters.quit_head();
+  return waiter;
+}
+// resume (never called with the lock held)
+template <typename T>
+void ForkChannel<T>::resume(std::coroutine_handle<> handle) {
+  if (executor) {
+    executor(handle);
+  } else {
+    handle.resume();
+  }
+}
+
+// PushAwaiter::await_suspend
+// returning false continues the pushing coroutine without suspending it
+template <typename T>
+bool ForkChannel<T>::PushAwaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+  std::unique_lock<std::mutex> lock(channel.mtx);
+  if (channel.closed) {
+    return false;
+  }
+  accepted = true;
+  if (channel.blocked_pop.get_size() > 0) {
+    // a consumer is already waiting, so the buffer is empty: hand over
+    PopAwaiter *consumer = take_head(channel.blocked_pop);
+    consumer->value.emplace(std::move(value));
+    lock.unlock();
+    channel.resume(consumer->handle);
+    return false;
+  }
+  if (channel.capacity == 0 || channel.buffer.get_size() < channel.capacity) {
+    channel.buffer.push(value);
+    return false;
+  }
+  accepted     = false;
+  this->handle = handle;
+  channel.blocked_push.push(this);
+  return true;
+}
+// PopAwaiter::await_suspend
+template <typename T>
+bool ForkChannel<T>::PopAwaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+  std::unique_lock<std::mutex> lock(channel.mtx);
+  if (channel.buffer.get_size() > 0) {
+    value.emplace(std::move(channel.buffer.data_head()->data));
+    channel.buffer.quit_head();
+    if (channel.blocked_push.get_size() > 0) {
+      // room freed up, move the oldest blocked producer into the buffer
+      PushAwaiter *producer = take_head(channel.blocked_push);
+      channel.buffer.push(producer->value);
+      producer->accepted = true;
+      lock.unlock();
+      channel.resume(producer->handle);
+    }
+    return false;
+  }
+  if (channel.closed) {
+    return false;
+  }
+  this->handle = handle;
+  channel.blocked_pop.push(this);
+  return true;
+}
+
+// push
+template <typename T>
+typename ForkChannel<T>::PushAwaiter ForkChannel<T>::push(T value) {
+  return PushAwaiter(*this, std::move(value));
+}
+// pop
+template <typename T>
+typename ForkChannel<T>::PopAwaiter ForkChannel<T>::pop() {
+  return PopAwaiter(*this);
+}
+// try_push
+template <typename T>
+bool ForkChannel<T>::try_push(const T &value) {
+  std::unique_lock<std::mutex> lock(mtx);
+  if (closed) {
+    return false;
+  }
+  if (blocked_pop.get_size() > 0) {
+    PopAwaiter *consumer = take_head(blocked_pop);
+    consumer->value.emplace(value);
+    lock.unlock();
+    resume(consumer->handle);
+    return true;
+  }
+  if (capacity > 0 && buffer.get_size() >= capacity) {
+    return false;
+  }
+  buffer.push(value);
+  return true;
+}
+// try_pop
+template <typename T>
+std::optional<T> ForkChannel<T>::try_pop() {
+  std::unique_lock<std::mutex> lock(mtx);
+  if (buffer.get_size() == 0) {
+    return std::nullopt;
+  }
+  std::optional<T> value(std::move(buffer.data_head()->data));
+  buffer.quit_head();
+  if (blocked_push.get_size() > 0) {
+    PushAwaiter *producer = take_head(blocked_push);
+    buffer.push(producer->value);
+    producer->accepted = true;
+    lock.unlock();
+    resume(producer->handle);
+  }
+  return value;
+}
+// close
+template <typename T>
+void ForkChannel<T>::close() {
+  std::unique_lock<std::mutex> lock(mtx);
+  closed = true;
+  // consumers only block on an empty buffer, so none of them will get data
+  ForkQueue<std::coroutine_handle<>> wake;
+  while (blocked_pop.get_size() > 0) {
+    wake.push(take_head(blocked_pop)->handle);
+  }
+  while (blocked_push.get_size() > 0) {
+    wake.push(take_head(blocked_push)->handle);  // accepted stays false
+  }
+  lock.unlock();
+  while (wake.get_size() > 0) {
+    resume(take_head(wake));
+  }
+}
+// is_closed
+template <typename T>
+bool ForkChannel<T>::is_closed() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return closed;
+}
+// get_size
+template <typename T>
+int ForkChannel<T>::get_size() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return buffer.get_size();
+}
+// get_capacity
+template <typename T>
+int ForkChannel<T>::get_capacity() const {
+  return capacity;
+}
@@ -0,0 +1,242 @@
+// grow-only concurrent vector for many appending threads
+// push_back reserves its index with one fetch_add, storage is a list of
+// geometrically growing segments that are never moved or freed until the
+// vector dies, so element addresses stay valid while writers continue
+//
+// readers see the prefix [0, GetSize()): every slot has a ready flag and
+// whichever writer completes the prefix moves it forward, so no writer
+// ever waits for another. a copy constructor that throws inside push_back
+// leaves a hole, and the prefix never moves past it
+
+/*
+ *  segments: [ 64 ] [ 128 ] [ 256 ] [ 512 ] ...
+ *  index i lives in segment k = log2(i / 64 + 1)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "ForkStats.hpp"
+
+template <typename T>
+class ForkConcurrentVector {
+public:
+  using value_type = T;
+  static constexpr int first_shift  = 6;  // first segment holds 64 elements
+  static constexpr int max_segments = 26;  // 64 * (2^26 - 1) > INT_MAX
+
+private:
+  using stats = ForkStatsOf<ForkConcurrentVector>;
+
+  class Segment {
+  public:
+    T *slots;                  // raw storage, constructed by push_back
+    std::atomic<bool> *ready;  // slot i is constructed
+    explicit Segment(const long long &length)
+        : slots(std::allocator<T>().allocate(length)),
+          ready(new std::atomic<bool>[length]()) {}
+  };
+
+  std::atomic<Segment *> segments[max_segments] = {};
+  alignas(64) std::atomic<long long> reserved{0};   // indices handed out
+  alignas(64) std::atomic<long long> committed{0};  // published prefix
+
+  static int segment_of(const long long &index);
+  static long long segment_start(const int &segment);
+  static long long segment_length(const int &segment);
+  T *slot(const long long &index) const;
+  bool is_ready(const long long &index) const;
+  Segment *ensure_segment(const int &segment);  // allocate on first use
+  void advance();  // move the published prefix over ready slots
+
+public:
+  // constructor and destructor
+  ForkConcurrentVector() = default;
+  ~ForkConcurrentVector();
+  ForkConcurrentVector(const ForkConcurrentVector &other)            = delete;
+  ForkConcurrentVector &operator=(const ForkConcurrentVector &other) = delete;
+
+  // functions (push_back and preAlloc may run on any number of threads)
+  int push_back(const T &value);  // returns the index of the new element
+  void preAlloc(const int &n);    // allocate the segments for n elements
+  T &GetElement(const int &index);
+  [[nodiscard]] int GetSize() const;      // published elements
+  [[nodiscard]] int GetCapacity() const;  // allocated slots
+  [[nodiscard]] bool is_empty() const;
+
+  // operator overloading
+  T &operator[](const int &index);
+  const T &operator[](const int &index) const;
+
+  // echo
+  void echo() const;
+};
+
+// destructor (no writer may be running)
+template <typename T>
+ForkConcurrentVector<T>::~ForkConcurrentVector() {
+  long long size = committed.load(std::memory_order_acquire);
+  for (long long i = 0; i < size; i++) {
+    slot(i)->~T();
+  }
+  stats::elements(-size);
+  for (int k = 0; k < max_segments; k++) {
+    Segment *segment = segments[k].load(std::memory_order_relaxed);
+    if (segment != nullptr) {
+      std::allocator<T>().deallocate(segment->slots, segment_length(k));
+      delete[] segment->ready;
+      delete segment;
+      stats::release(segment_length(k) * sizeof(T));
+    }
+  }
+}
+
+// segment_of
+template <typename T>
+int ForkConcurrentVector<T>::segment_of(const long long &index) {
+  auto biased = static_cast<unsigned long long>(index + (1LL << first_shift));
+  return std::bit_width(biased) - 1 - first_shift;
+}
+// segment_start (first index stored in the segment)
+template <typename T>
+long long ForkConcurrentVector<T>::segment_start(const int &segment) {
+  return (1LL << (segment + first_shift)) - (1LL << first_shift);
+}
+// segment_length
+template <typename T>
+long long ForkConcurrentVector<T>::segment_length(const int &segment) {
+  return 1LL << (segment + first_shift);
+}
+// slot
+template <typename T>
+T *ForkConcurrentVector<T>::slot(const long long &index) const {
+  int k = segment_of(index);
+  return segments[k].load(std::memory_order_acquire)->slots + index -
+         segment_start(k);
+}
+// is_ready (the segment of a reserved index may not exist yet)
+template <typename T>
+bool ForkConcurrentVector<T>::is_ready(const long long &index) const {
+  int k            = segment_of(index);
+  Segment *segment = segments[k].load(std::memory_order_acquire);
+  return segment != nullptr && segment->ready[index - segment_start(k)].load();
+}
+// ensure_segment (racing threads allocate, one wins, the rest free theirs)
+template <typename T>
+typename ForkConcurrentVector<T>::Segment *
+ForkConcurrentVector<T>::ensure_segment(const int &segment) {
+  Segment *current = segments[segment].load(std::memory_order_acquire);
+  if (current != nullptr) {
+    return current;
+  }
+  auto *fresh = new Segment(segment_length(segment));
+  if (segments[segment].compare_exchange_strong(current, fresh,
+                                                std::memory_order_acq_rel)) {
+    stats::allocate(segment_length(segment) * sizeof(T));
+    return fresh;
+  }
+  std::allocator<T>().deallocate(fresh->slots, segment_length(segment));
+  delete[] fresh->ready;
+  delete fresh;
+  return current;
+}
+// advance
+// seq_cst on the flags and the prefix: of two writers finishing next to
+// each other, at least one sees the other's flag and carries the prefix on
+template <typename T>
+void ForkConcurrentVector<T>::advance() {
+  long long done = committed.load();
+  while (done < reserved.load() && is_ready(done)) {
+    if (committed.compare_exchange_weak(done, done + 1)) {
+      ++done;
+    }
+  }
+}
+
+// push_back
+template <typename T>
+int ForkConcurrentVector<T>::push_back(const T &value) {
+  long long index = reserved.fetch_add(1, std::memory_order_relaxed);
+  if (index >= INT_MAX) {
+    reserved.fetch_sub(1, std::memory_order_relaxed);
+    throw std::length_error("ForkConcurrentVector is full");
+  }
+  int k            = segment_of(index);
+  Segment *segment = ensure_segment(k);
+  new (segment->slots + index - segment_start(k)) T(value);
+  segment->ready[index - segment_start(k)].store(true);
+  advance();
+  stats::elements(1);
+  return static_cast<int>(index);
+}
+// preAlloc
+template <typename T>
+void ForkConcurrentVector<T>::preAlloc(const int &n) {
+  if (n <= 0) {
+    return;
+  }
+  int last = segment_of(n - 1);
+  for (int k = 0; k <= last; k++) {
+    ensure_segment(k);
+  }
+}
+// get_element
+template <typename T>
+T &ForkConcurrentVector<T>::GetElement(const int &index) {
+  return (*this)[index];
+}
+// get_size
+template <typename T>
+int ForkConcurrentVector<T>::GetSize() const {
+  return static_cast<int>(committed.load(std::memory_order_acquire));
+}
+// get_capacity
+template <typename T>
+int ForkConcurrentVector<T>::GetCapacity() const {
+  long long capacity = 0;
+  for (int k = 0; k < max_segments; k++) {
+    if (segments[k].load(std::memory_order_acquire) != nullptr) {
+      capacity += segment_length(k);
+    }
+  }
+  return capacity > INT_MAX ? INT_MAX : static_cast<int>(capacity);
+}
+// is_empty
+template <typename T>
+bool ForkConcurrentVector<T>::is_empty() const {
+  return GetSize() == 0;
+}
+
+// operator []
+template <typename T>
+T &ForkConcurrentVector<T>::operator[](const int &index) {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return *slot(index);
+}
+template <typename T>
+const T &ForkConcurrentVector<T>::operator[](const int &index) const {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return *slot(index);
+}
+
+// echo
+template <typename T>
+void ForkConcurrentVector<T>::echo() const {
+  std::cout << "current concurrent vector: ";
+  int size = GetSize();
+  for (int i = 0; i < size; i++) {
+    std::cout << *slot(i) << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
@@ -0,0 +1,412 @@
+// segmented double-ended queue
+// elements live in fixed-size blocks, a map of block pointers grows at both
+// ends, so push/pop at either end and random access are all O(1) and no
+// element is ever moved by an insertion at the ends
+
+/*
+ *  map:   [ null | blk | blk | blk | null ]
+ *                   ^head          ^head + size
+ */
+
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "ForkExport.hpp"
+
+template <typename T>
+class ForkDeque {
+public:
+  // about one page of elements per block, but never fewer than 16
+  static constexpr int block_size =
+      sizeof(T) * 16 < 4096 ? static_cast<int>(4096 / sizeof(T)) : 16;
+
+private:
+  T **map          = nullptr;  // block pointers, null outside the used range
+  int map_capacity = 0;        // num of slots in map
+  int head         = 0;        // absolute position of the first element
+  int size         = 0;        // num of elements
+  T *spare         = nullptr;  // one released block, kept to avoid thrashing
+
+  T *slot(const int &pos) const;  // address of absolute position pos
+  T *new_block();
+  void release_block(const int &block);
+  void grow_map();
+
+public:
+  // constructor and destructor
+  ForkDeque() = default;
+  ~ForkDeque();
+  ForkDeque(const ForkDeque &other);
+  ForkDeque(ForkDeque &&other) noexcept;
+
+  // functions
+  void push_back(const T &value);
+  void push_front(const T &value);
+  void pop_back();
+  void pop_front();
+  T &front();
+  T &back();
+  void erase();          // remove everything, release all blocks
+  void clear();          // = erase()
+  void shrink_to_fit();  // drop the spare block and unused map slots
+  T &GetElement(const int &index);
+  void SetElement(const int &index, const T &value);
+  [[nodiscard]] int GetIndex(const T &value) const;
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] bool is_empty() const;
+
+  // iterator yields T &, const_iterator (from a const deque) const T &
+  template <bool Const>
+  class basic_iterator {
+  private:
+    using owner_type = std::conditional_t<Const, const ForkDeque, ForkDeque>;
+    using reference  = std::conditional_t<Const, const T &, T &>;
+    owner_type *deque;
+    int index;
+    friend class ForkDeque;
+
+  public:
+    basic_iterator(owner_type *deque, int index)
+        : deque(deque), index(index) {}
+    operator basic_iterator<true>() const
+      requires(!Const)
+    {
+      return {deque, index};
+    }
+    reference operator*() const { return *deque->slot(deque->head + index); }
+    basic_iterator &operator++() {
+      ++index;
+      return *this;
+    }
+    basic_iterator &operator--() {
+      --index;
+      return *this;
+    }
+    bool operator==(const basic_iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const basic_iterator &other) const {
+      return index != other.index;
+    }
+  };
+  using iterator       = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size); }
+
+  // operator overloading
+  T &operator[](const int &index);
+  const T &operator[](const int &index) const;
+  ForkDeque &operator=(const ForkDeque &other);
+  ForkDeque &operator=(ForkDeque &&other) noexcept;
+  bool operator==(const ForkDeque &other) const;
+  bool operator!=(const ForkDeque &other) const;
+
+  // echo and export
+  void echo() const;
+  void export_to(ForkExport &out) const;  // front to back, one record
+};
+
+// destructor
+template <typename T>
+ForkDeque<T>::~ForkDeque() {
+  erase();
+  shrink_to_fit();
+}
+// copy constructor
+template <typename T>
+ForkDeque<T>::ForkDeque(const ForkDeque &other) {
+  for (int i = 0; i < other.size; i++) {
+    push_back(*other.slot(other.head + i));
+  }
+}
+// move constructor
+template <typename T>
+ForkDeque<T>::ForkDeque(ForkDeque &&other) noexcept {
+  map                = other.map;
+  map_capacity       = other.map_capacity;
+  head               = other.head;
+  size               = other.size;
+  spare              = other.spare;
+  other.map          = nullptr;
+  other.map_capacity = 0;
+  other.head         = 0;
+  other.size         = 0;
+  other.spare        = nullptr;
+}
+
+// slot
+template <typename T>
+T *ForkDeque<T>::slot(const int &pos) const {
+  return map[pos / block_size] + pos % block_size;
+}
+// new_block (raw storage, elements are constructed in place)
+template <typename T>
+T *ForkDeque<T>::new_block() {
+  if (spare != nullptr) {
+    T *block = spare;
+    spare    = nullptr;
+    return block;
+  }
+  return std::allocator<T>().allocate(block_size);
+}
+// release_block
+template <typename T>
+void ForkDeque<T>::release_block(const int &block) {
+  if (spare == nullptr) {
+    spare = map[block];
+  } else {
+    std::allocator<T>().deallocate(map[block], block_size);
+  }
+  map[block] = nullptr;
+}
+// grow_map (recenter when at most half full, otherwise double)
+// afterwards there is at least one free slot on either side of the blocks
+template <typename T>
+void ForkDeque<T>::grow_map() {
+  int first_block = head / block_size;
+  int used_blocks = 0;
+  int capacity    = map_capacity;
+  if (size > 0) {
+    used_blocks = (head + size - 1) / block_size - first_block + 1;
+  }
+  if (capacity < 8) {
+    capacity = 8;
+  } else if (used_blocks * 2 + 2 > capacity) {
+    capacity *= 2;
+  }
+  int new_first = (capacity - used_blocks) / 2;
+  T **new_map   = new T *[capacity]();
+  for (int i = 0; i < used_blocks; i++) {
+    new_map[new_first + i] = map[first_block + i];
+  }
+  delete[] map;
+  map          = new_map;
+  map_capacity = capacity;
+  head         = new_first * block_size + head % block_size;
+}
+
+// push_back
+template <typename T>
+void ForkDeque<T>::push_back(const T &value) {
+  int pos = head + size;
+  if (pos == map_capacity * block_size) {
+    grow_map();
+    pos = head + size;
+  }
+  if (map[pos / block_size] == nullptr) {
+    map[pos / block_size] = new_block();
+  }
+  new (slot(pos)) T(value);
+  ++size;
+}
+// push_front
+template <typename T>
+void ForkDeque<T>::push_front(const T &value) {
+  if (head == 0) {
+    grow_map();
+  }
+  int pos = head - 1;
+  if (map[pos / block_size] == nullptr) {
+    map[pos / block_size] = new_block();
+  }
+  new (slot(pos)) T(value);
+  head = pos;
+  ++size;
+}
+// pop_back
+template <typename T>
+void ForkDeque<T>::pop_back() {
+  if (size == 0) {
+    return;
+  }
+  int pos = head + size - 1;
+  slot(pos)->~T();
+  --size;
+  if (size == 0 || pos % block_size == 0) {
+    release_block(pos / block_size);
+  }
+}
+// pop_front
+template <typename T>
+void ForkDeque<T>::pop_front() {
+  if (size == 0) {
+    return;
+  }
+  int pos = head;
+  slot(pos)->~T();
+  ++head;
+  --size;
+  if (size == 0 || head % block_size == 0) {
+    release_block(pos / block_size);
+  }
+}
+// front
+template <typename T>
+T &ForkDeque<T>::front() {
+  if (size == 0) {
+    throw std::out_of_range("deque is empty");
+  }
+  return *slot(head);
+}
+// back
+template <typename T>
+T &ForkDeque<T>::back() {
+  if (size == 0) {
+    throw std::out_of_range("deque is empty");
+  }
+  return *slot(head + size - 1);
+}
+// erase
+template <typename T>
+void ForkDeque<T>::erase() {
+  while (size > 0) {
+    pop_back();
+  }
+}
+// clear
+template <typename T>
+void ForkDeque<T>::clear() {
+  erase();
+}
+// shrink_to_fit
+template <typename T>
+void ForkDeque<T>::shrink_to_fit() {
+  if (spare != nullptr) {
+    std::allocator<T>().deallocate(spare, block_size);
+    spare = nullptr;
+  }
+  if (size == 0) {
+    for (int i = 0; i < map_capacity; i++) {
+      if (map[i] != nullptr) {
+        std::allocator<T>().deallocate(map[i], block_size);
+      }
+    }
+    delete[] map;
+    map          = nullptr;
+    map_capacity = 0;
+    head         = 0;
+  }
+}
+// get_element
+template <typename T>
+T &ForkDeque<T>::GetElement(const int &index) {
+  return (*this)[index];
+}
+// set_element
+template <typename T>
+void ForkDeque<T>::SetElement(const int &index, const T &value) {
+  (*this)[index] = value;
+}
+// get_index
+template <typename T>
+int ForkDeque<T>::GetIndex(const T &value) const {
+  for (int i = 0; i < size; i++) {
+    if (*slot(head + i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+// get_size
+template <typename T>
+int ForkDeque<T>::GetSize() const {
+  return size;
+}
+// is_empty
+template <typename T>
+bool ForkDeque<T>::is_empty() const {
+  return size == 0;
+}
+
+// operator []
+template <typename T>
+T &ForkDeque<T>::operator[](const int &index) {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return *slot(head + index);
+}
+template <typename T>
+const T &ForkDeque<T>::operator[](const int &index) const {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return *slot(head + index);
+}
+// copy assignment
+template <typename T>
+ForkDeque<T> &ForkDeque<T>::operator=(const ForkDeque &other) {
+  if (this == &other) {
+    return *this;
+  }
+  erase();
+  for (int i = 0; i < other.size; i++) {
+    push_back(*other.slot(other.head + i));
+  }
+  return *this;
+}
+// move assignment
+template <typename T>
+ForkDeque<T> &ForkDeque<T>::operator=(ForkDeque &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  erase();
+  shrink_to_fit();
+  map                = other.map;
+  map_capacity       = other.map_capacity;
+  head               = other.head;
+  size               = other.size;
+  spare              = other.spare;
+  other.map          = nullptr;
+  other.map_capacity = 0;
+  other.head         = 0;
+  other.size         = 0;
+  other.spare        = nullptr;
+  return *this;
+}
+// operator ==
+template <typename T>
+bool ForkDeque<T>::operator==(const ForkDeque &other) const {
+  if (size != other.size) {
+    return false;
+  }
+  for (int i = 0; i < size; i++) {
+    if (*slot(head + i) != *other.slot(other.head + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+// operator !=
+template <typename T>
+bool ForkDeque<T>::operator!=(const ForkDeque &other) const {
+  return !(*this == other);
+}
+
+// echo
+template <typename T>
+void ForkDeque<T>::echo() const {
+  std::cout << "current deque: ";
+  for (int i = 0; i < size; i++) {
+    std::cout << *slot(head + i) << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+// export_to
+template <typename T>
+void ForkDeque<T>::export_to(ForkExport &out) const {
+  for (int i = 0; i < size; i++) {
+    out.add(*slot(head + i));
+  }
+  out.end_record();
+}
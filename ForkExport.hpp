@@ -0,0 +1,215 @@
+// buffered export of container contents
+// elements are formatted into one reusable buffer (std::to_chars for
+// numbers, raw bytes for strings, operator<< for everything else) and the
+// whole buffer goes to the sink in a single write
+//
+//   ForkExport out(ForkLayout::csv);
+//   vec.export_to(out);    // "1,2,3\n"
+//   list.export_to(out);   // appended as the next record
+//   out.flush(fd);         // one write(2), buffer is kept for reuse
+
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+enum class ForkLayout {
+  csv,    // one record per container, comma separated, RFC 4180 quoting
+  lines,  // one element per line
+};
+
+class ForkExport {
+private:
+  char *buffer      = nullptr;
+  int size          = 0;
+  int capacity      = 0;
+  ForkLayout layout = ForkLayout::lines;
+  bool in_record    = false;  // csv: a field was written since end_record()
+  std::ostringstream fallback;  // for types without a faster path
+
+  void reserve_more(const int &n);  // room for n more bytes
+  void append_raw(const char *text, const int &length);
+  void append_field(std::string_view text);  // csv-quoted when needed
+
+public:
+  // constructor and destructor
+  explicit ForkExport(const ForkLayout &layout = ForkLayout::lines);
+  ~ForkExport();
+  ForkExport(const ForkExport &other)            = delete;
+  ForkExport &operator=(const ForkExport &other) = delete;
+
+  template <typename T>
+  void add(const T &value);  // one element plus its delimiter
+  void end_record();         // csv: terminate the current row
+
+  [[nodiscard]] std::string_view view() const;  // formatted bytes so far
+  [[nodiscard]] int GetSize() const;
+  void preAlloc(const int &n);  // reserve n bytes up front
+  void clear();                 // drop the bytes, keep the buffer
+
+  // sinks, each is one bulk write that empties the buffer on success
+  bool flush(const int &fd);  // write(2), retries partial writes and EINTR
+  bool flush(FILE *file);     // fwrite
+  void flush(std::string &out);
+};
+
+// constructor
+inline ForkExport::ForkExport(const ForkLayout &layout) : layout(layout) {}
+// destructor
+inline ForkExport::~ForkExport() {
+  delete[] buffer;
+}
+
+// reserve_more
+inline void ForkExport::reserve_more(const int &n) {
+  if (size + n <= capacity) {
+    return;
+  }
+  int new_capacity = capacity > 0 ? capacity * 2 : 256;
+  while (new_capacity < size + n) {
+    new_capacity *= 2;
+  }
+  preAlloc(new_capacity);
+}
+// append_raw
+inline void ForkExport::append_raw(const char *text, const int &length) {
+  if (length == 0) {
+    return;
+  }
+  reserve_more(length);
+  std::memcpy(buffer + size, text, length);
+  size += length;
+}
+// append_field
+inline void ForkExport::append_field(std::string_view text) {
+  if (layout != ForkLayout::csv ||
+      text.find_first_of(",\"\r\n") == std::string_view::npos) {
+    append_raw(text.data(), static_cast<int>(text.size()));
+    return;
+  }
+  reserve_more(static_cast<int>(text.size()) * 2 + 2);
+  buffer[size++] = '"';
+  for (char c : text) {
+    if (c == '"') {
+      buffer[size++] = '"';
+    }
+    buffer[size++] = c;
+  }
+  buffer[size++] = '"';
+}
+
+// add
+template <typename T>
+void ForkExport::add(const T &value) {
+  if (layout == ForkLayout::csv && in_record) {
+    append_raw(",", 1);
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    append_raw(value ? "true" : "false", value ? 4 : 5);
+  } else if constexpr (std::is_same_v<T, char>) {
+    append_field(std::string_view(&value, 1));
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    reserve_more(64);  // enough for any integer or shortest long double
+    auto result = std::to_chars(buffer + size, buffer + capacity, value);
+    while (result.ec == std::errc::value_too_large) {  // wider extensions
+      reserve_more(2 * (capacity - size));
+      result = std::to_chars(buffer + size, buffer + capacity, value);
+    }
+    size = static_cast<int>(result.ptr - buffer);
+  } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+    append_field(std::string_view(value));
+  } else {
+    fallback.str("");
+    fallback << value;
+    append_field(fallback.str());
+  }
+  if (layout == ForkLayout::lines) {
+    append_raw("\n", 1);
+  } else {
+    in_record = true;
+  }
+}
+// end_record
+inline void ForkExport::end_record() {
+  if (layout == ForkLayout::csv) {
+    append_raw("\n", 1);
+    in_record = false;
+  }
+}
+// view
+inline std::string_view ForkExport::view() const {
+  return {buffer, static_cast<std::string_view::size_type>(size)};
+}
+// get_size
+inline int ForkExport::GetSize() const {
+  return size;
+}
+// pre_alloc
+inline void ForkExport::preAlloc(const int &n) {
+  if (n <= capacity) {
+    return;
+  }
+  char *new_buffer = new char[n];
+  if (size > 0) {
+    std::memcpy(new_buffer, buffer, size);
+  }
+  delete[] buffer;
+  buffer   = new_buffer;
+  capacity = n;
+}
+// clear
+inline void ForkExport::clear() {
+  size      = 0;
+  in_record = false;
+}
+
+// flush (fd)
+inline bool ForkExport::flush(const int &fd) {
+#ifdef __unix__
+  int done = 0;
+  while (done < size) {
+    ssize_t n = write(fd, buffer + done, size - done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      // keep what was not written, the caller may retry
+      std::memmove(buffer, buffer + done, size - done);
+      size -= done;
+      return false;
+    }
+    done += static_cast<int>(n);
+  }
+  size = 0;
+  return true;
+#else
+  return false;
+#endif
+}
+// flush (FILE*)
+inline bool ForkExport::flush(FILE *file) {
+  int done = static_cast<int>(std::fwrite(buffer, 1, size, file));
+  if (done < size) {
+    // keep what was not written, the caller may retry
+    std::memmove(buffer, buffer + done, size - done);
+    size -= done;
+    return false;
+  }
+  size = 0;
+  return true;
+}
+// flush (string)
+inline void ForkExport::flush(std::string &out) {
+  out.append(buffer, size);
+  size = 0;
+}
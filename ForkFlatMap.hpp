@@ -0,0 +1,485 @@
+// sorted flat containers for read-mostly lookups
+// ForkFlatSet keeps its keys in one sorted ForkVector, ForkFlatMap keeps
+// keys and values in two parallel ForkVectors, so a search only walks the
+// densely packed keys. lookups are a branchless binary search, which turns
+// the unpredictable compare into a conditional move
+//
+// single inserts and erases shift the tail (O(n)); build from a range or
+// insert_batch() instead: one sort of the new keys, then a single merge pass
+// duplicate keys keep their first occurrence, existing entries win
+
+/*
+ *  keys:   [ 2 | 3 | 5 | 7 | 11 ]
+ *  values: [ b | c | e | g | k  ]   (ForkFlatMap only)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkVector.hpp"
+
+// first position in the sorted range [first, first + n) not less than key
+template <typename K, typename Q, typename Compare>
+int fork_lower_bound(const K *first, const int &n, const Q &key,
+                     const Compare &compare) {
+  if (n == 0) {
+    return 0;
+  }
+  const K *base = first;
+  int length    = n;
+  while (length > 1) {
+    int half = length / 2;
+    base     = compare(base[half], key) ? base + half : base;
+    length -= half;
+  }
+  return static_cast<int>(base - first) + (compare(*base, key) ? 1 : 0);
+}
+
+template <typename K, typename Compare = std::less<>>
+class ForkFlatSet {
+public:
+  using value_type = K;
+
+private:
+  ForkVector<K> keys;  // sorted, unique
+  Compare compare;
+
+  template <typename Q>
+  [[nodiscard]] bool equal_at(const int &index, const Q &key) const;
+
+public:
+  // constructor and destructor
+  explicit ForkFlatSet(const Compare &compare = Compare());
+  template <typename InputIt>
+  ForkFlatSet(InputIt first, InputIt last,
+              const Compare &compare = Compare());  // sort + dedupe once
+
+  // functions
+  bool insert(const K &key);  // false if present
+  template <typename InputIt>
+  void insert_batch(InputIt first, InputIt last);  // sort, then one merge
+  template <typename Q>
+  bool erase(const Q &key);  // false if absent
+  template <typename Q>
+  [[nodiscard]] bool contains(const Q &key) const;
+  template <typename Q>
+  [[nodiscard]] int GetIndex(const Q &key) const;  // position or -1
+  template <typename Q>
+  [[nodiscard]] int lower_bound(const Q &key) const;
+  void preAlloc(const int &n);
+  void erase();  // remove everything
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] bool is_empty() const;
+  const K *begin() const { return keys.GetPtr(); }
+  const K *end() const { return keys.GetPtr() + keys.GetSize(); }
+
+  // operator overloading
+  const K &operator[](const int &index) const;  // index-th smallest key
+
+  // echo
+  void echo() const;
+};
+
+template <typename K, typename V, typename Compare = std::less<>>
+class ForkFlatMap {
+public:
+  using value_type = V;
+
+private:
+  ForkVector<K> keys;    // sorted, unique
+  ForkVector<V> values;  // values[i] belongs to keys[i]
+  Compare compare;
+
+  template <typename Q>
+  [[nodiscard]] int find_index(const Q &key) const;  // position or -1
+  int insert_at(const int &index, const K &key, const V &value);
+
+public:
+  // constructor and destructor
+  explicit ForkFlatMap(const Compare &compare = Compare());
+  template <typename InputIt>
+  ForkFlatMap(InputIt first, InputIt last,
+              const Compare &compare = Compare());  // pairs, sort + dedupe
+
+  // functions
+  bool insert(const K &key, const V &value);  // false if present
+  void insert_or_assign(const K &key, const V &value);
+  template <typename InputIt>
+  void insert_batch(InputIt first, InputIt last);  // pairs, one merge
+  template <typename Q>
+  bool erase(const Q &key);  // false if absent
+  template <typename Q>
+  [[nodiscard]] bool contains(const Q &key) const;
+  template <typename Q>
+  V *find(const Q &key);  // nullptr if absent
+  template <typename Q>
+  const V *find(const Q &key) const;
+  template <typename Q>
+  V &get(const Q &key);  // throws if absent
+  template <typename Q>
+  [[nodiscard]] int lower_bound(const Q &key) const;
+  [[nodiscard]] const K &GetKey(const int &index) const;
+  V &GetValue(const int &index);
+  void preAlloc(const int &n);
+  void erase();  // remove everything
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] bool is_empty() const;
+
+  // operator overloading
+  V &operator[](const K &key);  // inserts V() if absent
+
+  // echo
+  void echo() const;
+};
+
+// ForkFlatSet
+
+// constructor
+template <typename K, typename Compare>
+ForkFlatSet<K, Compare>::ForkFlatSet(const Compare &compare)
+    : compare(compare) {}
+// constructor (bulk build)
+template <typename K, typename Compare>
+template <typename InputIt>
+ForkFlatSet<K, Compare>::ForkFlatSet(InputIt first, InputIt last,
+                                     const Compare &compare)
+    : compare(compare) {
+  insert_batch(first, last);
+}
+// equal_at
+template <typename K, typename Compare>
+template <typename Q>
+bool ForkFlatSet<K, Compare>::equal_at(const int &index, const Q &key) const {
+  return index < keys.GetSize() && !compare(key, keys.GetPtr()[index]);
+}
+// insert
+template <typename K, typename Compare>
+bool ForkFlatSet<K, Compare>::insert(const K &key) {
+  int index = lower_bound(key);
+  if (equal_at(index, key)) {
+    return false;
+  }
+  keys.push_back(key);
+  K *data = keys.GetPtr();
+  std::rotate(data + index, data + keys.GetSize() - 1, data + keys.GetSize());
+  return true;
+}
+// insert_batch
+template <typename K, typename Compare>
+template <typename InputIt>
+void ForkFlatSet<K, Compare>::insert_batch(InputIt first, InputIt last) {
+  ForkVector<K> batch;
+  for (; first != last; ++first) {
+    batch.push_back(*first);
+  }
+  K *added = batch.GetPtr();
+  int m    = batch.GetSize();
+  auto equivalent = [this](const K &a, const K &b) {
+    return !compare(a, b) && !compare(b, a);
+  };
+  std::stable_sort(added, added + m, compare);
+  m = static_cast<int>(std::unique(added, added + m, equivalent) - added);
+  // merge the sorted batch and the current keys in one pass
+  K *old = keys.GetPtr();
+  int n  = keys.GetSize();
+  ForkVector<K> merged;
+  merged.resize(n + m);
+  K *out = merged.GetPtr();
+  int i  = 0;
+  int j  = 0;
+  int w  = 0;
+  while (i < n || j < m) {
+    if (j == m || (i < n && !compare(added[j], old[i]))) {
+      if (j < m && !compare(old[i], added[j])) {
+        ++j;  // already present
+      }
+      out[w++] = std::move(old[i++]);
+    } else {
+      out[w++] = std::move(added[j++]);
+    }
+  }
+  merged.resize(w);
+  keys = std::move(merged);
+}
+// erase [key]
+template <typename K, typename Compare>
+template <typename Q>
+bool ForkFlatSet<K, Compare>::erase(const Q &key) {
+  int index = GetIndex(key);
+  if (index < 0) {
+    return false;
+  }
+  keys.clear(index);
+  return true;
+}
+// contains
+template <typename K, typename Compare>
+template <typename Q>
+bool ForkFlatSet<K, Compare>::contains(const Q &key) const {
+  return GetIndex(key) >= 0;
+}
+// get_index
+template <typename K, typename Compare>
+template <typename Q>
+int ForkFlatSet<K, Compare>::GetIndex(const Q &key) const {
+  int index = lower_bound(key);
+  return equal_at(index, key) ? index : -1;
+}
+// lower_bound
+template <typename K, typename Compare>
+template <typename Q>
+int ForkFlatSet<K, Compare>::lower_bound(const Q &key) const {
+  return fork_lower_bound(keys.GetPtr(), keys.GetSize(), key, compare);
+}
+// pre_alloc
+template <typename K, typename Compare>
+void ForkFlatSet<K, Compare>::preAlloc(const int &n) {
+  keys.preAlloc(n);
+}
+// erase all
+template <typename K, typename Compare>
+void ForkFlatSet<K, Compare>::erase() {
+  keys.erase();
+}
+// get_size
+template <typename K, typename Compare>
+int ForkFlatSet<K, Compare>::GetSize() const {
+  return keys.GetSize();
+}
+// is_empty
+template <typename K, typename Compare>
+bool ForkFlatSet<K, Compare>::is_empty() const {
+  return keys.GetSize() == 0;
+}
+// operator []
+template <typename K, typename Compare>
+const K &ForkFlatSet<K, Compare>::operator[](const int &index) const {
+  if (index < 0 || index >= keys.GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return keys.GetPtr()[index];
+}
+// echo
+template <typename K, typename Compare>
+void ForkFlatSet<K, Compare>::echo() const {
+  std::cout << "current flat set: ";
+  for (const K &key : *this) {
+    std::cout << key << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+
+// ForkFlatMap
+
+// constructor
+template <typename K, typename V, typename Compare>
+ForkFlatMap<K, V, Compare>::ForkFlatMap(const Compare &compare)
+    : compare(compare) {}
+// constructor (bulk build)
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+ForkFlatMap<K, V, Compare>::ForkFlatMap(InputIt first, InputIt last,
+                                        const Compare &compare)
+    : compare(compare) {
+  insert_batch(first, last);
+}
+// find_index
+template <typename K, typename V, typename Compare>
+template <typename Q>
+int ForkFlatMap<K, V, Compare>::find_index(const Q &key) const {
+  int index = lower_bound(key);
+  if (index < keys.GetSize() && !compare(key, keys.GetPtr()[index])) {
+    return index;
+  }
+  return -1;
+}
+// insert_at (shift the tails of both vectors by one)
+template <typename K, typename V, typename Compare>
+int ForkFlatMap<K, V, Compare>::insert_at(const int &index, const K &key,
+                                          const V &value) {
+  keys.push_back(key);
+  values.push_back(value);
+  int n = keys.GetSize();
+  std::rotate(keys.GetPtr() + index, keys.GetPtr() + n - 1,
+              keys.GetPtr() + n);
+  std::rotate(values.GetPtr() + index, values.GetPtr() + n - 1,
+              values.GetPtr() + n);
+  return index;
+}
+// insert
+template <typename K, typename V, typename Compare>
+bool ForkFlatMap<K, V, Compare>::insert(const K &key, const V &value) {
+  int index = lower_bound(key);
+  if (index < keys.GetSize() && !compare(key, keys.GetPtr()[index])) {
+    return false;
+  }
+  insert_at(index, key, value);
+  return true;
+}
+// insert_or_assign
+template <typename K, typename V, typename Compare>
+void ForkFlatMap<K, V, Compare>::insert_or_assign(const K &key,
+                                                  const V &value) {
+  int index = lower_bound(key);
+  if (index < keys.GetSize() && !compare(key, keys.GetPtr()[index])) {
+    values.GetPtr()[index] = value;
+  } else {
+    insert_at(index, key, value);
+  }
+}
+// insert_batch
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+void ForkFlatMap<K, V, Compare>::insert_batch(InputIt first, InputIt last) {
+  ForkVector<std::pair<K, V>> batch;
+  for (; first != last; ++first) {
+    batch.push_back(std::pair<K, V>(first->first, first->second));
+  }
+  std::pair<K, V> *added = batch.GetPtr();
+  int m                  = batch.GetSize();
+  auto less = [this](const std::pair<K, V> &a, const std::pair<K, V> &b) {
+    return compare(a.first, b.first);
+  };
+  auto equivalent = [&less](const std::pair<K, V> &a,
+                            const std::pair<K, V> &b) {
+    return !less(a, b) && !less(b, a);
+  };
+  std::stable_sort(added, added + m, less);
+  m = static_cast<int>(std::unique(added, added + m, equivalent) - added);
+  // merge the sorted batch and the current entries in one pass
+  K *old_keys = keys.GetPtr();
+  V *old_vals = values.GetPtr();
+  int n       = keys.GetSize();
+  ForkVector<K> merged_keys;
+  ForkVector<V> merged_values;
+  merged_keys.resize(n + m);
+  merged_values.resize(n + m);
+  K *out_keys = merged_keys.GetPtr();
+  V *out_vals = merged_values.GetPtr();
+  int i       = 0;
+  int j       = 0;
+  int w       = 0;
+  while (i < n || j < m) {
+    if (j == m || (i < n && !compare(added[j].first, old_keys[i]))) {
+      if (j < m && !compare(old_keys[i], added[j].first)) {
+        ++j;  // already present, the existing value wins
+      }
+      out_keys[w]   = std::move(old_keys[i]);
+      out_vals[w++] = std::move(old_vals[i++]);
+    } else {
+      out_keys[w]   = std::move(added[j].first);
+      out_vals[w++] = std::move(added[j++].second);
+    }
+  }
+  merged_keys.resize(w);
+  merged_values.resize(w);
+  keys   = std::move(merged_keys);
+  values = std::move(merged_values);
+}
+// erase [key]
+template <typename K, typename V, typename Compare>
+template <typename Q>
+bool ForkFlatMap<K, V, Compare>::erase(const Q &key) {
+  int index = find_index(key);
+  if (index < 0) {
+    return false;
+  }
+  keys.clear(index);
+  values.clear(index);
+  return true;
+}
+// contains
+template <typename K, typename V, typename Compare>
+template <typename Q>
+bool ForkFlatMap<K, V, Compare>::contains(const Q &key) const {
+  return find_index(key) >= 0;
+}
+// find
+template <typename K, typename V, typename Compare>
+template <typename Q>
+V *ForkFlatMap<K, V, Compare>::find(const Q &key) {
+  int index = find_index(key);
+  return index >= 0 ? values.GetPtr() + index : nullptr;
+}
+template <typename K, typename V, typename Compare>
+template <typename Q>
+const V *ForkFlatMap<K, V, Compare>::find(const Q &key) const {
+  int index = find_index(key);
+  return index >= 0 ? values.GetPtr() + index : nullptr;
+}
+// get
+template <typename K, typename V, typename Compare>
+template <typename Q>
+V &ForkFlatMap<K, V, Compare>::get(const Q &key) {
+  int index = find_index(key);
+  if (index < 0) {
+    throw std::out_of_range("key not found");
+  }
+  return values.GetPtr()[index];
+}
+// lower_bound
+template <typename K, typename V, typename Compare>
+template <typename Q>
+int ForkFlatMap<K, V, Compare>::lower_bound(const Q &key) const {
+  return fork_lower_bound(keys.GetPtr(), keys.GetSize(), key, compare);
+}
+// get_key
+template <typename K, typename V, typename Compare>
+const K &ForkFlatMap<K, V, Compare>::GetKey(const int &index) const {
+  if (index < 0 || index >= keys.GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return keys.GetPtr()[index];
+}
+// get_value
+template <typename K, typename V, typename Compare>
+V &ForkFlatMap<K, V, Compare>::GetValue(const int &index) {
+  return values[index];
+}
+// pre_alloc
+template <typename K, typename V, typename Compare>
+void ForkFlatMap<K, V, Compare>::preAlloc(const int &n) {
+  keys.preAlloc(n);
+  values.preAlloc(n);
+}
+// erase all
+template <typename K, typename V, typename Compare>
+void ForkFlatMap<K, V, Compare>::erase() {
+  keys.erase();
+  values.erase();
+}
+// get_size
+template <typename K, typename V, typename Compare>
+int ForkFlatMap<K, V, Compare>::GetSize() const {
+  return keys.GetSize();
+}
+// is_empty
+template <typename K, typename V, typename Compare>
+bool ForkFlatMap<K, V, Compare>::is_empty() const {
+  return keys.GetSize() == 0;
+}
+// operator []
+template <typename K, typename V, typename Compare>
+V &ForkFlatMap<K, V, Compare>::operator[](const K &key) {
+  int index = lower_bound(key);
+  if (index == keys.GetSize() || compare(key, keys.GetPtr()[index])) {
+    insert_at(index, key, V());
+  }
+  return values.GetPtr()[index];
+}
+// echo
+template <typename K, typename V, typename Compare>
+void ForkFlatMap<K, V, Compare>::echo() const {
+  std::cout << "current flat map: ";
+  for (int i = 0; i < keys.GetSize(); i++) {
+    std::cout << keys.GetPtr()[i] << ": " << values.GetPtr()[i] << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
@@ -0,0 +1,382 @@
+// gap buffer: a ForkVector with a movable hole for clustered edits
+// the free capacity sits at the cursor instead of at the end, so insert and
+// clear(index) next to the last edit cost O(1); an edit somewhere else
+// first moves the gap there, shifting only the elements in between
+//
+// indexing hides the gap, [i] and GetElement(i) see a plain sequence
+
+/*
+ *  logical: [ a | b | c | d | e ]          cursor = 2
+ *  storage: [ a | b | _ | _ | _ | c | d | e ]
+ *                   ^gap_start  ^gap_end
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkExport.hpp"
+#include "ForkStats.hpp"
+
+template <typename T>
+class ForkGapBuffer {
+public:
+  using value_type = T;
+
+private:
+  using stats = ForkStatsOf<ForkGapBuffer>;  // no-op unless FORK_STL_STATS
+
+  T *data       = nullptr;
+  int capacity  = 0;
+  int gap_start = 0;  // first slot of the gap == cursor
+  int gap_end   = 0;  // first slot after the gap
+
+  [[nodiscard]] int gap() const { return gap_end - gap_start; }
+  [[nodiscard]] int slot(const int &index) const;  // logical -> storage
+  void move_gap(const int &index);
+  void reallocate(const int &n);  // keeps the gap at the cursor
+
+public:
+  // constructor and destructor
+  ForkGapBuffer() = default;
+  ~ForkGapBuffer();
+  ForkGapBuffer(const ForkGapBuffer &other);
+  ForkGapBuffer(ForkGapBuffer &&other) noexcept;
+
+  // functions
+  void preAlloc(const int &n);                        // pre_allocate_capacity
+  void insert(const int &index, const T &value);      // before index
+  void push_back(const T &value);                     // push_back
+  void pop_back();                                    // pop_back
+  void clear(const int &index);                       // clear [data_only]
+  void clear();                                       // clear [data_only]
+  void erase(const int &index);                       // erase [data & capacity]
+  void erase();                                       // erase [data & capacity]
+  void shrink_to_fit();                               // shrink_to_fit
+  void SetCursor(const int &index);                   // move the gap now
+  [[nodiscard]] int GetCursor() const;                // where the gap sits
+  [[nodiscard]] int GetSize() const;                  // get_size
+  [[nodiscard]] int GetCapacity() const;              // get_capacity
+  T &GetElement(const int &index);                    // get_element
+  void SetElement(const int &index, const T &value);  // set_element
+  [[nodiscard]] int GetIndex(const T &value) const;   // get_index
+  void ResetAll(const T &value);                      // reset all elements
+
+  // operator overloading
+  T &operator[](const int &index);
+  const T &operator[](const int &index) const;
+  ForkGapBuffer &operator=(const ForkGapBuffer &other);
+  ForkGapBuffer &operator=(ForkGapBuffer &&other) noexcept;
+  bool operator==(const ForkGapBuffer &other) const;
+  bool operator!=(const ForkGapBuffer &other) const;
+
+  // echo
+  void echo() const;
+  void export_to(ForkExport &out) const;  // append as one record
+};
+
+// slot
+template <typename T>
+int ForkGapBuffer<T>::slot(const int &index) const {
+  return index < gap_start ? index : index + gap();
+}
+// move_gap (shift the elements between the old and the new cursor)
+template <typename T>
+void ForkGapBuffer<T>::move_gap(const int &index) {
+  if (gap() == 0) {
+    gap_start = index;  // an empty gap is anywhere, and no self-moves
+    gap_end   = index;
+  } else if (index < gap_start) {
+    std::move_backward(data + index, data + gap_start, data + gap_end);
+    stats::walk(gap_start - index);
+    gap_end -= gap_start - index;
+    gap_start = index;
+  } else if (index > gap_start) {
+    std::move(data + gap_end, data + gap_end + index - gap_start,
+              data + gap_start);
+    stats::walk(index - gap_start);
+    gap_end += index - gap_start;
+    gap_start = index;
+  }
+}
+// reallocate
+template <typename T>
+void ForkGapBuffer<T>::reallocate(const int &n) {
+  int size = GetSize();
+  int tail = capacity - gap_end;
+  T *temp  = new T[n];
+  stats::reallocate(capacity * sizeof(T), n * sizeof(T), size * sizeof(T));
+  std::move(data, data + gap_start, temp);
+  std::move(data + gap_end, data + capacity, temp + n - tail);
+  delete[] data;
+  data     = temp;
+  capacity = n;
+  gap_end  = n - tail;
+  stats::shape(size, capacity);
+}
+
+// destructor
+template <typename T>
+ForkGapBuffer<T>::~ForkGapBuffer() {
+  if (data != nullptr) {
+    stats::release(capacity * sizeof(T));
+    stats::elements(-GetSize());
+  }
+  delete[] data;
+}
+// copy constructor (the copy starts with its gap at the end)
+template <typename T>
+ForkGapBuffer<T>::ForkGapBuffer(const ForkGapBuffer &other) {
+  int size = other.GetSize();
+  if (size == 0) {
+    return;
+  }
+  data     = new T[size];
+  capacity = size;
+  std::copy(other.data, other.data + other.gap_start, data);
+  std::copy(other.data + other.gap_end, other.data + other.capacity,
+            data + other.gap_start);
+  gap_start = size;
+  gap_end   = size;
+  stats::allocate(capacity * sizeof(T));
+  stats::elements(size);
+  stats::shape(size, capacity);
+}
+// move constructor
+template <typename T>
+ForkGapBuffer<T>::ForkGapBuffer(ForkGapBuffer &&other) noexcept
+    : data(other.data),
+      capacity(other.capacity),
+      gap_start(other.gap_start),
+      gap_end(other.gap_end) {
+  other.data      = nullptr;
+  other.capacity  = 0;
+  other.gap_start = 0;
+  other.gap_end   = 0;
+}
+
+// pre_allocate_capacity
+template <typename T>
+void ForkGapBuffer<T>::preAlloc(const int &n) {
+  if (n > capacity) {
+    reallocate(n);
+  }
+}
+// insert
+template <typename T>
+void ForkGapBuffer<T>::insert(const int &index, const T &value) {
+  if (index < 0 || index > GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  move_gap(index);
+  if (gap() == 0) {
+    reallocate(capacity > 0 ? capacity * 2 : 1);
+  }
+  data[gap_start++] = value;
+  stats::elements(1);
+  stats::shape(GetSize(), capacity);
+}
+// push_back
+template <typename T>
+void ForkGapBuffer<T>::push_back(const T &value) {
+  insert(GetSize(), value);
+}
+// pop_back
+template <typename T>
+void ForkGapBuffer<T>::pop_back() {
+  if (GetSize() > 0) {
+    clear(GetSize() - 1);
+  }
+}
+// clear [index] (the element joins the gap, the cursor stays at index)
+template <typename T>
+void ForkGapBuffer<T>::clear(const int &index) {
+  if (index < 0 || index >= GetSize()) {
+    return;
+  }
+  if (index == gap_start - 1) {
+    data[--gap_start] = T();  // backspace
+  } else {
+    move_gap(index);
+    data[gap_end++] = T();  // delete
+  }
+  stats::elements(-1);
+}
+// clear all
+template <typename T>
+void ForkGapBuffer<T>::clear() {
+  stats::elements(-GetSize());
+  gap_start = 0;
+  gap_end   = capacity;
+}
+// erase [index]
+template <typename T>
+void ForkGapBuffer<T>::erase(const int &index) {
+  if (index < 0 || index >= GetSize()) {
+    return;
+  }
+  clear(index);
+  shrink_to_fit();
+}
+// erase all
+template <typename T>
+void ForkGapBuffer<T>::erase() {
+  clear();
+  shrink_to_fit();
+}
+// shrink_to_fit (drops the gap, the next edit grows it again)
+template <typename T>
+void ForkGapBuffer<T>::shrink_to_fit() {
+  if (gap() == 0) {
+    return;
+  }
+  if (GetSize() == 0) {
+    stats::release(capacity * sizeof(T));
+    delete[] data;
+    data      = nullptr;
+    capacity  = 0;
+    gap_start = 0;
+    gap_end   = 0;
+    return;
+  }
+  reallocate(GetSize());
+}
+// set_cursor
+template <typename T>
+void ForkGapBuffer<T>::SetCursor(const int &index) {
+  if (index < 0 || index > GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  move_gap(index);
+}
+// get_cursor
+template <typename T>
+int ForkGapBuffer<T>::GetCursor() const {
+  return gap_start;
+}
+// get_size
+template <typename T>
+int ForkGapBuffer<T>::GetSize() const {
+  return capacity - gap();
+}
+// get_capacity
+template <typename T>
+int ForkGapBuffer<T>::GetCapacity() const {
+  return capacity;
+}
+// get_element
+template <typename T>
+T &ForkGapBuffer<T>::GetElement(const int &index) {
+  return (*this)[index];
+}
+// set_element
+template <typename T>
+void ForkGapBuffer<T>::SetElement(const int &index, const T &value) {
+  (*this)[index] = value;
+}
+// get_index
+template <typename T>
+int ForkGapBuffer<T>::GetIndex(const T &value) const {
+  int size = GetSize();
+  for (int i = 0; i < size; i++) {
+    if (data[slot(i)] == value) {
+      stats::walk(i + 1);
+      return i;
+    }
+  }
+  stats::walk(size);
+  return -1;
+}
+// ResetAll (with parameter)
+template <typename T>
+void ForkGapBuffer<T>::ResetAll(const T &value) {
+  std::fill(data, data + gap_start, value);
+  std::fill(data + gap_end, data + capacity, value);
+}
+
+// operator []
+template <typename T>
+T &ForkGapBuffer<T>::operator[](const int &index) {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return data[slot(index)];
+}
+template <typename T>
+const T &ForkGapBuffer<T>::operator[](const int &index) const {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return data[slot(index)];
+}
+// copy assignment
+template <typename T>
+ForkGapBuffer<T> &ForkGapBuffer<T>::operator=(const ForkGapBuffer &other) {
+  if (this == &other) {
+    return *this;
+  }
+  ForkGapBuffer copy(other);
+  *this = std::move(copy);
+  return *this;
+}
+// move assignment
+template <typename T>
+ForkGapBuffer<T> &ForkGapBuffer<T>::operator=(ForkGapBuffer &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (data != nullptr) {
+    stats::release(capacity * sizeof(T));
+    stats::elements(-GetSize());
+  }
+  delete[] data;
+  data            = other.data;
+  capacity        = other.capacity;
+  gap_start       = other.gap_start;
+  gap_end         = other.gap_end;
+  other.data      = nullptr;
+  other.capacity  = 0;
+  other.gap_start = 0;
+  other.gap_end   = 0;
+  return *this;
+}
+// operator ==
+template <typename T>
+bool ForkGapBuffer<T>::operator==(const ForkGapBuffer &other) const {
+  if (GetSize() != other.GetSize()) {
+    return false;
+  }
+  for (int i = 0; i < GetSize(); i++) {
+    if (data[slot(i)] != other.data[other.slot(i)]) {
+      return false;
+    }
+  }
+  return true;
+}
+// operator !=
+template <typename T>
+bool ForkGapBuffer<T>::operator!=(const ForkGapBuffer &other) const {
+  return !(*this == other);
+}
+
+// echo
+template <typename T>
+void ForkGapBuffer<T>::echo() const {
+  std::cout << "current gap buffer: ";
+  for (int i = 0; i < GetSize(); i++) {
+    std::cout << data[slot(i)] << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+// export_to
+template <typename T>
+void ForkGapBuffer<T>::export_to(ForkExport &out) const {
+  for (int i = 0; i < GetSize(); i++) {
+    out.add(data[slot(i)]);
+  }
+  out.end_record();
+}
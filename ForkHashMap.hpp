@@ -0,0 +1,597 @@
+// open-addressing hash map (Swiss table layout)
+// one control byte per slot: empty, deleted, or the low 7 bits of the hash
+// (h2) for a full slot. lookups load 16 control bytes at once and compare
+// them against h2 with SSE2 (a portable loop elsewhere), so most probes
+// touch one group and only the matching slots are compared by key
+//
+// slots and control bytes are two flat arrays, capacity is a power of two
+// and at most 7/8 of it is used. the first 16 control bytes are mirrored
+// after the last one so a group can be loaded at any position
+//
+// heterogeneous lookup: when Hash and Equal both define is_transparent,
+// find / contains / erase / get accept any key type they can compare
+// (ForkHash<std::string> takes std::string_view and const char *)
+
+/*
+ *  ctrl:  [ h2 | empty | h2 | deleted | ... | mirror of ctrl[0..15] ]
+ *  slots: [ kv |       | kv |         | ... ]
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "ForkStats.hpp"
+
+// default hash, std::hash except that strings hash transparently
+template <typename K>
+class ForkHash {
+public:
+  std::size_t operator()(const K &key) const { return std::hash<K>()(key); }
+};
+template <>
+class ForkHash<std::string> {
+public:
+  using is_transparent = void;
+  std::size_t operator()(std::string_view key) const {
+    return std::hash<std::string_view>()(key);
+  }
+};
+
+// key parameter type: the lookup type itself when transparent, else K
+template <bool transparent>
+class ForkKeyArg {
+public:
+  template <typename Q, typename K>
+  using type = K;
+};
+template <>
+class ForkKeyArg<true> {
+public:
+  template <typename Q, typename K>
+  using type = Q;
+};
+
+template <typename K, typename V, typename Hash = ForkHash<K>,
+          typename Equal = std::equal_to<>>
+class ForkHashMap {
+public:
+  class Slot {
+  public:
+    K key;
+    V value;
+  };
+  using value_type                = Slot;
+  static constexpr int group_size = 16;
+
+private:
+  using stats = ForkStatsOf<ForkHashMap>;  // no-op unless FORK_STL_STATS
+  static constexpr bool transparent =
+      requires { typename Hash::is_transparent; } &&
+      requires { typename Equal::is_transparent; };
+  template <typename Q>
+  using key_arg = typename ForkKeyArg<transparent>::template type<Q, K>;
+
+  static constexpr std::int8_t empty   = -128;  // 0b10000000
+  static constexpr std::int8_t deleted = -2;    // 0b11111110
+
+  // 16 control bytes, each match returns one bit per slot
+  class Group {
+  private:
+#if defined(__SSE2__)
+    __m128i bytes;
+#else
+    std::int8_t bytes[group_size];
+#endif
+
+  public:
+    explicit Group(const std::int8_t *pos);
+    [[nodiscard]] unsigned match(const std::int8_t &h2) const;
+    [[nodiscard]] unsigned match_empty() const;
+    [[nodiscard]] unsigned match_free() const;  // empty or deleted
+  };
+
+  std::int8_t *ctrl = nullptr;  // capacity + group_size control bytes
+  Slot *slots       = nullptr;  // raw storage, full slots are constructed
+  int capacity      = 0;        // num of slots, 0 or a power of two >= 16
+  int size          = 0;        // num of full slots
+  int growth_left   = 0;        // inserts into empty slots before a rehash
+  Hash hasher;
+  Equal equal;
+
+  static std::size_t mix(std::size_t hash);  // spread weak std::hash values
+  static int max_load(const int &capacity);  // 7/8 of capacity
+  template <typename Q>
+  [[nodiscard]] std::size_t hash_of(const Q &key) const;
+  void set_ctrl(const int &index, const std::int8_t &value);
+  template <typename Q>
+  [[nodiscard]] int find_index(const Q &key) const;  // slot or -1
+  int find_free(const std::size_t &hash) const;      // first non-full slot
+  void rehash(const int &new_capacity);
+  void release();
+  template <typename Q, typename... Args>
+  std::pair<int, bool> emplace_key(const Q &key, Args &&...args);
+
+public:
+  // constructor and destructor
+  ForkHashMap() = default;
+  ~ForkHashMap();
+  ForkHashMap(const ForkHashMap &other);
+  ForkHashMap(ForkHashMap &&other) noexcept;
+
+  // functions
+  bool insert(const K &key, const V &value);  // false if the key exists
+  void insert_or_assign(const K &key, const V &value);
+  template <typename Q = K>
+  V *find(const key_arg<Q> &key);  // nullptr if absent
+  template <typename Q = K>
+  const V *find(const key_arg<Q> &key) const;
+  template <typename Q = K>
+  [[nodiscard]] bool contains(const key_arg<Q> &key) const;
+  template <typename Q = K>
+  V &get(const key_arg<Q> &key);  // throws if absent
+  template <typename Q = K>
+  bool erase(const key_arg<Q> &key);  // false if absent
+  void reserve(const int &n);         // room for n keys without a rehash
+  void clear();                       // remove all, keep capacity
+  void erase();                       // remove all, release memory
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] int get_capacity() const;
+  [[nodiscard]] bool is_empty() const;
+
+  // iterator (slot order, unspecified), the key is read-only
+  template <bool Const>
+  class basic_iterator {
+  private:
+    using owner_type = std::conditional_t<Const, const ForkHashMap,
+                                          ForkHashMap>;
+    using value_ref  = std::conditional_t<Const, const V &, V &>;
+    owner_type *map;
+    int index;
+    void skip() {
+      while (index < map->capacity && map->ctrl[index] < 0) {
+        ++index;
+      }
+    }
+
+  public:
+    basic_iterator(owner_type *map, int index) : map(map), index(index) {
+      skip();
+    }
+    operator basic_iterator<true>() const
+      requires(!Const)
+    {
+      return {map, index};
+    }
+    const K &key() const { return map->slots[index].key; }
+    value_ref value() const { return map->slots[index].value; }
+    std::pair<const K &, value_ref> operator*() const {
+      return {key(), value()};
+    }
+    basic_iterator &operator++() {
+      ++index;
+      skip();
+      return *this;
+    }
+    bool operator==(const basic_iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const basic_iterator &other) const {
+      return index != other.index;
+    }
+  };
+  using iterator       = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, capacity); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, capacity); }
+
+  // operator overloading
+  V &operator[](const K &key);  // inserts V() if absent
+  ForkHashMap &operator=(const ForkHashMap &other);
+  ForkHashMap &operator=(ForkHashMap &&other) noexcept;
+
+  // echo
+  void echo() const;
+};
+
+// Group
+#if defined(__SSE2__)
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal>::Group::Group(const std::int8_t *pos)
+    : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+template <typename K, typename V, typename Hash, typename Equal>
+unsigned ForkHashMap<K, V, Hash, Equal>::Group::match(
+    const std::int8_t &h2) const {
+  return static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2))));
+}
+template <typename K, typename V, typename Hash, typename Equal>
+unsigned ForkHashMap<K, V, Hash, Equal>::Group::match_empty() const {
+  return static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(empty))));
+}
+template <typename K, typename V, typename Hash, typename Equal>
+unsigned ForkHashMap<K, V, Hash, Equal>::Group::match_free() const {
+  return static_cast<unsigned>(_mm_movemask_epi8(bytes));  // sign bit set
+}
+#else
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal>::Group::Group(const std::int8_t *pos) {
+  for (int i = 0; i < group_size; i++) {
+    bytes[i] = pos[i];
+  }
+}
+template <typename K, typename V, typename Hash, typename Equal>
+unsigned ForkHashMap<K, V, Hash, Equal>::Group::match(
+    const std::int8_t &h2) const {
+  unsigned mask = 0;
+  for (int i = 0; i < group_size; i++) {
+    mask |= static_cast<unsigned>(bytes[i] == h2) << i;
+  }
+  return mask;
+}
+template <typename K, typename V, typename Hash, typename Equal>
+unsigned ForkHashMap<K, V, Hash, Equal>::Group::match_empty() const {
+  return match(empty);
+}
+template <typename K, typename V, typename Hash, typename Equal>
+unsigned ForkHashMap<K, V, Hash, Equal>::Group::match_free() const {
+  unsigned mask = 0;
+  for (int i = 0; i < group_size; i++) {
+    mask |= static_cast<unsigned>(bytes[i] < 0) << i;
+  }
+  return mask;
+}
+#endif
+
+// destructor
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal>::~ForkHashMap() {
+  release();
+}
+// copy constructor
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal>::ForkHashMap(const ForkHashMap &other)
+    : hasher(other.hasher), equal(other.equal) {
+  reserve(other.size);
+  for (auto [key, value] : other) {
+    emplace_key(key, value);
+  }
+}
+// move constructor
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal>::ForkHashMap(ForkHashMap &&other) noexcept
+    : hasher(std::move(other.hasher)), equal(std::move(other.equal)) {
+  ctrl              = other.ctrl;
+  slots             = other.slots;
+  capacity          = other.capacity;
+  size              = other.size;
+  growth_left       = other.growth_left;
+  other.ctrl        = nullptr;
+  other.slots       = nullptr;
+  other.capacity    = 0;
+  other.size        = 0;
+  other.growth_left = 0;
+}
+
+// mix (the murmur3 finalizer)
+template <typename K, typename V, typename Hash, typename Equal>
+std::size_t ForkHashMap<K, V, Hash, Equal>::mix(std::size_t hash) {
+  std::uint64_t h = hash;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<std::size_t>(h);
+}
+// max_load
+template <typename K, typename V, typename Hash, typename Equal>
+int ForkHashMap<K, V, Hash, Equal>::max_load(const int &capacity) {
+  return capacity - capacity / 8;
+}
+// hash_of
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+std::size_t ForkHashMap<K, V, Hash, Equal>::hash_of(const Q &key) const {
+  return mix(hasher(key));
+}
+// set_ctrl (keeps the mirrored tail in sync)
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::set_ctrl(const int &index,
+                                              const std::int8_t &value) {
+  ctrl[index] = value;
+  if (index < group_size) {
+    ctrl[capacity + index] = value;
+  }
+}
+// find_index (triangular probing over groups visits every group once)
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+int ForkHashMap<K, V, Hash, Equal>::find_index(const Q &key) const {
+  if (size == 0) {
+    return -1;
+  }
+  std::size_t hash = hash_of(key);
+  auto h2          = static_cast<std::int8_t>(hash & 0x7f);
+  std::size_t mask = capacity - 1;
+  std::size_t pos  = (hash >> 7) & mask;
+  std::size_t step = 0;
+  int groups       = 1;
+  while (true) {
+    Group group(ctrl + pos);
+    for (unsigned match = group.match(h2); match != 0; match &= match - 1) {
+      int index = static_cast<int>((pos + std::countr_zero(match)) & mask);
+      if (equal(slots[index].key, key)) {
+        stats::walk(groups);
+        return index;
+      }
+    }
+    if (group.match_empty() != 0) {
+      stats::walk(groups);
+      return -1;
+    }
+    step += group_size;
+    pos = (pos + step) & mask;
+    ++groups;
+  }
+}
+// find_free
+template <typename K, typename V, typename Hash, typename Equal>
+int ForkHashMap<K, V, Hash, Equal>::find_free(const std::size_t &hash) const {
+  std::size_t mask = capacity - 1;
+  std::size_t pos  = (hash >> 7) & mask;
+  std::size_t step = 0;
+  while (true) {
+    unsigned free = Group(ctrl + pos).match_free();
+    if (free != 0) {
+      return static_cast<int>((pos + std::countr_zero(free)) & mask);
+    }
+    step += group_size;
+    pos = (pos + step) & mask;
+  }
+}
+// rehash (moves every key into fresh arrays, drops tombstones)
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::rehash(const int &new_capacity) {
+  std::int8_t *old_ctrl = ctrl;
+  Slot *old_slots       = slots;
+  int old_capacity      = capacity;
+  capacity              = new_capacity;
+  ctrl                  = new std::int8_t[capacity + group_size];
+  slots                 = std::allocator<Slot>().allocate(capacity);
+  for (int i = 0; i < capacity + group_size; i++) {
+    ctrl[i] = empty;
+  }
+  growth_left = max_load(capacity) - size;
+  for (int i = 0; i < old_capacity; i++) {
+    if (old_ctrl[i] >= 0) {
+      std::size_t hash = hash_of(old_slots[i].key);
+      int index        = find_free(hash);
+      new (slots + index) Slot(std::move(old_slots[i]));
+      old_slots[i].~Slot();
+      set_ctrl(index, static_cast<std::int8_t>(hash & 0x7f));
+    }
+  }
+  if (old_ctrl != nullptr) {
+    stats::reallocate(old_capacity * (sizeof(Slot) + 1),
+                      capacity * (sizeof(Slot) + 1), size * sizeof(Slot));
+    std::allocator<Slot>().deallocate(old_slots, old_capacity);
+    delete[] old_ctrl;
+  } else {
+    stats::allocate(capacity * (sizeof(Slot) + 1));
+  }
+  stats::shape(size, capacity);
+}
+// release
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::release() {
+  if (ctrl == nullptr) {
+    return;
+  }
+  clear();
+  stats::release(capacity * (sizeof(Slot) + 1));
+  std::allocator<Slot>().deallocate(slots, capacity);
+  delete[] ctrl;
+  ctrl        = nullptr;
+  slots       = nullptr;
+  capacity    = 0;
+  growth_left = 0;
+}
+// emplace_key (index of the key, and whether it was inserted)
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q, typename... Args>
+std::pair<int, bool> ForkHashMap<K, V, Hash, Equal>::emplace_key(
+    const Q &key, Args &&...args) {
+  int found = find_index(key);
+  if (found >= 0) {
+    return {found, false};
+  }
+  if (growth_left == 0) {
+    // mostly tombstones: clean up in place, otherwise double
+    bool crowded = capacity == 0 || size > max_load(capacity) / 2;
+    rehash(crowded ? (capacity > 0 ? capacity * 2 : group_size) : capacity);
+  }
+  std::size_t hash = hash_of(key);
+  int index        = find_free(hash);
+  new (slots + index) Slot{K(key), V(std::forward<Args>(args)...)};
+  if (ctrl[index] == empty) {
+    --growth_left;
+  }
+  set_ctrl(index, static_cast<std::int8_t>(hash & 0x7f));
+  ++size;
+  stats::elements(1);
+  stats::shape(size, capacity);
+  return {index, true};
+}
+
+// insert
+template <typename K, typename V, typename Hash, typename Equal>
+bool ForkHashMap<K, V, Hash, Equal>::insert(const K &key, const V &value) {
+  return emplace_key(key, value).second;
+}
+// insert_or_assign
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::insert_or_assign(const K &key,
+                                                      const V &value) {
+  auto [index, inserted] = emplace_key(key, value);
+  if (!inserted) {
+    slots[index].value = value;
+  }
+}
+// find
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+V *ForkHashMap<K, V, Hash, Equal>::find(const key_arg<Q> &key) {
+  int index = find_index(key);
+  return index >= 0 ? &slots[index].value : nullptr;
+}
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+const V *ForkHashMap<K, V, Hash, Equal>::find(const key_arg<Q> &key) const {
+  int index = find_index(key);
+  return index >= 0 ? &slots[index].value : nullptr;
+}
+// contains
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+bool ForkHashMap<K, V, Hash, Equal>::contains(const key_arg<Q> &key) const {
+  return find_index(key) >= 0;
+}
+// get
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+V &ForkHashMap<K, V, Hash, Equal>::get(const key_arg<Q> &key) {
+  int index = find_index(key);
+  if (index < 0) {
+    throw std::out_of_range("key not found");
+  }
+  return slots[index].value;
+}
+// erase [key] (leaves a tombstone so longer probe chains stay intact)
+template <typename K, typename V, typename Hash, typename Equal>
+template <typename Q>
+bool ForkHashMap<K, V, Hash, Equal>::erase(const key_arg<Q> &key) {
+  int index = find_index(key);
+  if (index < 0) {
+    return false;
+  }
+  slots[index].~Slot();
+  set_ctrl(index, deleted);
+  --size;
+  stats::elements(-1);
+  return true;
+}
+// reserve
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::reserve(const int &n) {
+  int wanted = group_size;
+  while (max_load(wanted) < n) {
+    wanted *= 2;
+  }
+  if (wanted > capacity) {
+    rehash(wanted);
+  }
+}
+// clear
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::clear() {
+  for (int i = 0; i < capacity; i++) {
+    if (ctrl[i] >= 0) {
+      slots[i].~Slot();
+    }
+  }
+  for (int i = 0; i < capacity + group_size && ctrl != nullptr; i++) {
+    ctrl[i] = empty;
+  }
+  stats::elements(-size);
+  size        = 0;
+  growth_left = max_load(capacity);
+}
+// erase all
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::erase() {
+  release();
+}
+// get_size
+template <typename K, typename V, typename Hash, typename Equal>
+int ForkHashMap<K, V, Hash, Equal>::get_size() const {
+  return size;
+}
+// get_capacity
+template <typename K, typename V, typename Hash, typename Equal>
+int ForkHashMap<K, V, Hash, Equal>::get_capacity() const {
+  return capacity;
+}
+// is_empty
+template <typename K, typename V, typename Hash, typename Equal>
+bool ForkHashMap<K, V, Hash, Equal>::is_empty() const {
+  return size == 0;
+}
+
+// operator []
+template <typename K, typename V, typename Hash, typename Equal>
+V &ForkHashMap<K, V, Hash, Equal>::operator[](const K &key) {
+  int index = emplace_key(key).first;  // may rehash, read slots after
+  return slots[index].value;
+}
+// copy assignment
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal> &ForkHashMap<K, V, Hash, Equal>::operator=(
+    const ForkHashMap &other) {
+  if (this == &other) {
+    return *this;
+  }
+  clear();
+  reserve(other.size);
+  for (auto [key, value] : other) {
+    emplace_key(key, value);
+  }
+  return *this;
+}
+// move assignment
+template <typename K, typename V, typename Hash, typename Equal>
+ForkHashMap<K, V, Hash, Equal> &ForkHashMap<K, V, Hash, Equal>::operator=(
+    ForkHashMap &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  release();
+  hasher            = std::move(other.hasher);
+  equal             = std::move(other.equal);
+  ctrl              = other.ctrl;
+  slots             = other.slots;
+  capacity          = other.capacity;
+  size              = other.size;
+  growth_left       = other.growth_left;
+  other.ctrl        = nullptr;
+  other.slots       = nullptr;
+  other.capacity    = 0;
+  other.size        = 0;
+  other.growth_left = 0;
+  return *this;
+}
+
+// echo
+template <typename K, typename V, typename Hash, typename Equal>
+void ForkHashMap<K, V, Hash, Equal>::echo() const {
+  std::cout << "current hash map: ";
+  for (auto [key, value] : *this) {
+    std::cout << key << ": " << value << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
@@ -0,0 +1,298 @@
+// in-process cache with O(1) get / put / evict
+// entries live in ForkList nodes, a ForkHashMap maps each key to its node,
+// so a hit relinks one node instead of searching the list by index
+//
+// the policy decides which of a few recency lists an entry sits in, the
+// victim is always the tail of the lowest non-empty list:
+//   lru  - one list, a hit moves the entry to the front
+//   slru - probation and protected lists, a second hit promotes an entry,
+//          protected keeps at most 80% of the budget and demotes its tail
+//   lfu  - one list per use count (saturating at 16), least used goes first,
+//          ties go to the least recently used
+// the budget is a number of entries and, optionally, a number of bytes
+
+/*
+ *  index: key -> node
+ *  lists: [0] head <-> ... <-> tail   (victim: tail of lowest non-empty list)
+ *         [1] head <-> ... <-> tail
+ */
+
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkHashMap.hpp"
+#include "ForkList.hpp"
+
+enum class ForkCachePolicy { lru, slru, lfu };
+
+template <typename K, typename V, typename Hash = ForkHash<K>>
+class ForkLRUCache {
+public:
+  using value_type               = V;
+  static constexpr int max_lists = 16;  // lfu use counts saturate here
+
+private:
+  class Entry {
+  public:
+    K key;
+    V value;
+    long long bytes = 0;
+    int list        = 0;  // which of lists[] holds the node
+  };
+  using Handle = decltype(std::declval<ForkList<Entry> &>().data_head());
+
+  ForkList<Entry> lists[max_lists];
+  long long list_bytes[max_lists] = {};
+  ForkHashMap<K, Handle, Hash> index;
+  ForkCachePolicy policy;
+  int max_entries;
+  long long max_bytes;  // 0 for no byte limit
+  long long bytes       = 0;
+  long long hit_count   = 0;
+  long long miss_count  = 0;
+  long long evict_count = 0;
+
+  void move(Handle node, const int &list);  // to the front of lists[list]
+  void touch(Handle node);                  // record a hit
+  void rebalance();                         // slru: cap the protected list
+  void evict_until(const int &entries, const long long &extra_bytes,
+                   Handle keep = nullptr);  // keep is never evicted
+  void remove(Handle node);
+
+public:
+  // constructor and destructor
+  explicit ForkLRUCache(const int &max_entries, const long long &max_bytes = 0,
+                        ForkCachePolicy policy = ForkCachePolicy::lru);
+  ForkLRUCache(const ForkLRUCache &other)            = delete;
+  ForkLRUCache &operator=(const ForkLRUCache &other) = delete;
+
+  // functions
+  V *get(const K &key);  // nullptr on a miss, counts hits and misses
+  bool put(const K &key, const V &value);  // weighs sizeof(K) + sizeof(V)
+  bool put(const K &key, const V &value,
+           const long long &size);  // false if it can never fit
+  bool erase(const K &key);         // false if absent
+  void erase();                     // drop every entry
+  [[nodiscard]] bool contains(const K &key) const;  // no promotion
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] long long get_bytes() const;
+  [[nodiscard]] bool is_empty() const;
+  [[nodiscard]] long long hits() const;
+  [[nodiscard]] long long misses() const;
+  [[nodiscard]] long long evictions() const;
+  [[nodiscard]] double hit_ratio() const;
+  void reset_counters();
+
+  // echo
+  void echo() const;
+};
+
+// constructor
+template <typename K, typename V, typename Hash>
+ForkLRUCache<K, V, Hash>::ForkLRUCache(const int &max_entries,
+                                       const long long &max_bytes,
+                                       ForkCachePolicy policy)
+    : policy(policy), max_entries(max_entries), max_bytes(max_bytes) {
+  if (max_entries <= 0 || max_bytes < 0) {
+    throw std::invalid_argument("cache budget must be positive");
+  }
+  index.reserve(max_entries);
+}
+
+// move
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::move(Handle node, const int &list) {
+  int from = node->data.list;
+  if (from == list) {
+    lists[list].move_to_front(node);
+    return;
+  }
+  lists[list].splice_front(lists[from], node);
+  list_bytes[from] -= node->data.bytes;
+  list_bytes[list] += node->data.bytes;
+  node->data.list = list;
+}
+// touch
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::touch(Handle node) {
+  int list = node->data.list;
+  if (policy == ForkCachePolicy::slru) {
+    move(node, 1);
+    rebalance();
+  } else if (policy == ForkCachePolicy::lfu && list + 1 < max_lists) {
+    move(node, list + 1);
+  } else {
+    lists[list].move_to_front(node);
+  }
+}
+// rebalance (demoted entries get one more chance on probation)
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::rebalance() {
+  int entry_cap       = max_entries - max_entries / 5;
+  long long bytes_cap = max_bytes - max_bytes / 5;
+  while (lists[1].GetSize() > 1 &&
+         (lists[1].GetSize() > entry_cap ||
+          (max_bytes > 0 && list_bytes[1] > bytes_cap))) {
+    move(lists[1].data_tail(), 0);
+  }
+}
+// evict_until (room for `entries` entries and `extra_bytes` more bytes)
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::evict_until(const int &entries,
+                                           const long long &extra_bytes,
+                                           Handle keep) {
+  int list = 0;
+  while (index.get_size() > entries ||
+         (max_bytes > 0 && bytes + extra_bytes > max_bytes)) {
+    Handle victim = lists[list].data_tail();
+    if (victim != nullptr && victim == keep) {
+      victim = victim->prev;
+    }
+    if (victim == nullptr) {
+      ++list;
+      continue;
+    }
+    remove(victim);
+    ++evict_count;
+  }
+}
+// remove
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::remove(Handle node) {
+  int list = node->data.list;
+  index.erase(node->data.key);
+  bytes -= node->data.bytes;
+  list_bytes[list] -= node->data.bytes;
+  lists[list].erase_node(node);
+}
+
+// get
+template <typename K, typename V, typename Hash>
+V *ForkLRUCache<K, V, Hash>::get(const K &key) {
+  Handle *found = index.find(key);
+  if (found == nullptr) {
+    ++miss_count;
+    return nullptr;
+  }
+  ++hit_count;
+  Handle node = *found;
+  touch(node);
+  return &node->data.value;
+}
+// put
+template <typename K, typename V, typename Hash>
+bool ForkLRUCache<K, V, Hash>::put(const K &key, const V &value) {
+  return put(key, value, static_cast<long long>(sizeof(K) + sizeof(V)));
+}
+template <typename K, typename V, typename Hash>
+bool ForkLRUCache<K, V, Hash>::put(const K &key, const V &value,
+                                   const long long &size) {
+  Handle *found = index.find(key);
+  if (max_bytes > 0 && size > max_bytes) {
+    if (found != nullptr) {
+      remove(*found);  // the old value must not outlive the new one
+    }
+    return false;
+  }
+  if (found != nullptr) {
+    Handle node = *found;
+    bytes += size - node->data.bytes;
+    list_bytes[node->data.list] += size - node->data.bytes;
+    node->data.value = value;
+    node->data.bytes = size;
+    touch(node);
+    evict_until(max_entries, 0, node);  // fits alone, size <= max_bytes
+    return true;
+  }
+  evict_until(max_entries - 1, size);
+  lists[0].push_front(Entry{key, value, size, 0});
+  index.insert(key, lists[0].data_head());
+  bytes += size;
+  list_bytes[0] += size;
+  return true;
+}
+// erase [key]
+template <typename K, typename V, typename Hash>
+bool ForkLRUCache<K, V, Hash>::erase(const K &key) {
+  Handle *found = index.find(key);
+  if (found == nullptr) {
+    return false;
+  }
+  remove(*found);
+  return true;
+}
+// erase all
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::erase() {
+  for (int i = 0; i < max_lists; i++) {
+    lists[i].erase();
+    list_bytes[i] = 0;
+  }
+  index.clear();
+  bytes = 0;
+}
+// contains
+template <typename K, typename V, typename Hash>
+bool ForkLRUCache<K, V, Hash>::contains(const K &key) const {
+  return index.contains(key);
+}
+// get_size
+template <typename K, typename V, typename Hash>
+int ForkLRUCache<K, V, Hash>::get_size() const {
+  return index.get_size();
+}
+// get_bytes
+template <typename K, typename V, typename Hash>
+long long ForkLRUCache<K, V, Hash>::get_bytes() const {
+  return bytes;
+}
+// is_empty
+template <typename K, typename V, typename Hash>
+bool ForkLRUCache<K, V, Hash>::is_empty() const {
+  return index.is_empty();
+}
+// hits
+template <typename K, typename V, typename Hash>
+long long ForkLRUCache<K, V, Hash>::hits() const {
+  return hit_count;
+}
+// misses
+template <typename K, typename V, typename Hash>
+long long ForkLRUCache<K, V, Hash>::misses() const {
+  return miss_count;
+}
+// evictions
+template <typename K, typename V, typename Hash>
+long long ForkLRUCache<K, V, Hash>::evictions() const {
+  return evict_count;
+}
+// hit_ratio
+template <typename K, typename V, typename Hash>
+double ForkLRUCache<K, V, Hash>::hit_ratio() const {
+  long long lookups = hit_count + miss_count;
+  return lookups == 0 ? 0.0 : static_cast<double>(hit_count) / lookups;
+}
+// reset_counters
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::reset_counters() {
+  hit_count   = 0;
+  miss_count  = 0;
+  evict_count = 0;
+}
+
+// echo (from the next victim to the safest entry)
+template <typename K, typename V, typename Hash>
+void ForkLRUCache<K, V, Hash>::echo() const {
+  std::cout << "current cache: ";
+  for (int i = 0; i < max_lists; i++) {
+    for (const auto *node = lists[i].data_tail(); node != nullptr;
+         node             = node->prev) {
+      std::cout << node->data.key << ": " << node->data.value << ", ";
+    }
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
@@ -1,29 +1,41 @@
-﻿// #pragma once
+﻿#pragma once
 
 #include <iostream>
 #include <iterator>
 
+#include "ForkChain.hpp"
+#include "ForkExport.hpp"
+#include "ForkStats.hpp"
+#include "ForkValueIndex.hpp"
+
 using namespace std;
 
 template <typename T>
 class ForkList {
+public:
+  using value_type = T;
+
 private:
-  class Node {
-  public:
-    T data;
-    Node *next = nullptr;
-    Node *prev = nullptr;
-  };
-  [[maybe_unused]] Node *head  = nullptr;  // head of the list
-  [[maybe_unused]] Node *tail  = nullptr;  // tail of the list
-  int size                     = 0;        // size of the list
-  [[maybe_unused]] int current = 0;        // current position in the list
+  using stats = ForkStatsOf<ForkList>;  // no-op unless FORK_STL_STATS
+  using Node  = ForkChainNode<T>;
+
+  [[maybe_unused]] Node *head    = nullptr;  // head of the list
+  [[maybe_unused]] Node *tail    = nullptr;  // tail of the list
+  int size                       = 0;        // size of the list
+  [[maybe_unused]] int current   = 0;        // current position in the list
+  ForkValueIndex<T> *value_index = nullptr;  // off unless EnableIndex()
+
+  void unlink(Node *node);      // detach, keep the node alive
+  void link_front(Node *node);  // attach a detached node as the head
 
 public:
   ForkList() = default;                 // constructor
   ~ForkList();                          // destructor
   ForkList(const ForkList &other);      // copy constructor
   ForkList(ForkList &&other) noexcept;  // move constructor
+  explicit ForkList(ForkChain<T> &&chain);  // adopts the nodes, head first
+  template <ForkChainSource<T> Source>
+  explicit ForkList(Source &&from);  // steals a ForkQueue / ForkStack, O(1)
 
   void push_back(const T &value);                     // push_back
   void pop_back();                                    // pop_back
@@ -35,14 +47,32 @@ public:
   void clear(const int &index);                       // clear index
   void ResetAll(const T &value);                      // reset all
   void echo() const;                                  // print the list
+  void export_to(ForkExport &out) const;              // append as one record
   void GetElement(const int &index);                  // get_element
   void SetElement(const int &index, const T &value);  // set_element
   auto data_head() -> decltype(head);                 // get the head_ptr
   auto data_tail() -> decltype(tail);                 // get the tail_ptr
+  auto data_head() const -> const Node *;             // read-only head_ptr
+  auto data_tail() const -> const Node *;             // read-only tail_ptr
   auto data_at(const int &index) -> decltype(head);   // get the data_at
   [[nodiscard]] int GetIndex(const T &value) const;   // get_index
   [[nodiscard]] int GetSize() const;                  // get_size
 
+  // opt-in value index, GetIndex becomes a hash probe (ForkValueIndex.hpp)
+  void EnableIndex(const int &bloom_bits = 0);  // bloom_bits 0: no filter
+  void DisableIndex();
+  void RebuildIndex();  // after writes through operator[] / data_at()
+  [[nodiscard]] bool IsIndexed() const;
+
+  // node handles from data_head() / data_tail() / data_at(), all O(1)
+  void move_to_front(decltype(head) node);                 // relink, no copy
+  void splice_front(ForkList &from, decltype(head) node);  // take over node
+  void erase_node(decltype(head) node);                    // unlink and free
+
+  // node handoff without copies (ForkChain.hpp), O(1) unless indexed
+  ForkChain<T> release_chain();            // give every node away
+  void splice_back(ForkChain<T> &&chain);  // append a batch at the tail
+
   T &operator[](const int &index);                 // operator []
   ForkList &operator=(const ForkList &other);      // copy assignment
   ForkList &operator=(ForkList &&other) noexcept;  // move assignment
@@ -57,7 +87,10 @@ ForkList<T>::~ForkList() {
     Node *temp = curr;
     curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
+  delete value_index;
 }
 template <typename T>
 ForkList<T>::ForkList(const ForkList &other) {
@@ -66,22 +99,29 @@ ForkList<T>::ForkList(const ForkList &other) {
     push_back(curr->data);
     curr = curr->next;
   }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
+  }
 }
 template <typename T>
 ForkList<T>::ForkList(ForkList &&other) noexcept {
-  head          = other.head;
-  tail          = other.tail;
-  size          = other.size;
-  current       = other.current;
-  other.head    = nullptr;
-  other.tail    = nullptr;
-  other.size    = 0;
-  other.current = 0;
+  head              = other.head;
+  tail              = other.tail;
+  size              = other.size;
+  current           = other.current;
+  value_index       = other.value_index;
+  other.head        = nullptr;
+  other.tail        = nullptr;
+  other.size        = 0;
+  other.current     = 0;
+  other.value_index = nullptr;
 }
 
 template <typename T>
 void ForkList<T>::push_back(const T &value) {
   Node *curr = new Node;
+  stats::allocate(sizeof(Node));
+  stats::elements(1);
   curr->data = value;
   if (!head) {
     head = curr;
@@ -91,22 +131,37 @@ void ForkList<T>::push_back(const T &value) {
     curr->prev = tail;
     tail       = curr;
   }
+  if (value_index != nullptr) {
+    value_index->push_back(curr->data);
+  }
   ++size;
+  stats::shape(size, size);
 }
 template <typename T>
 void ForkList<T>::pop_back() {
   if (size == 0) {
     return;
   }
+  if (value_index != nullptr) {
+    value_index->pop_back(tail->data);
+  }
   Node *curr = tail;
   tail       = tail->prev;
-  tail->next = nullptr;
+  if (tail != nullptr) {
+    tail->next = nullptr;
+  } else {
+    head = nullptr;
+  }
   delete curr;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
   --size;
 }
 template <typename T>
 void ForkList<T>::push_front(const T &value) {
   Node *curr = new Node;
+  stats::allocate(sizeof(Node));
+  stats::elements(1);
   curr->data = value;
   curr->next = head;
   curr->prev = nullptr;
@@ -117,17 +172,30 @@ void ForkList<T>::push_front(const T &value) {
   if (tail == nullptr) {
     tail = head;
   }
+  if (value_index != nullptr) {
+    value_index->push_front(curr->data);
+  }
   ++size;
+  stats::shape(size, size);
 }
 template <typename T>
 void ForkList<T>::pop_front() {
   if (size == 0) {
     return;
   }
+  if (value_index != nullptr) {
+    value_index->pop_front(head->data);
+  }
   Node *curr = head;
   head       = head->next;
-  head->prev = nullptr;
+  if (head != nullptr) {
+    head->prev = nullptr;
+  } else {
+    tail = nullptr;
+  }
   delete curr;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
   --size;
 }
 template <typename T>
@@ -141,10 +209,15 @@ void ForkList<T>::erase() {
     Node *temp = curr;
     curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
   head = nullptr;
   tail = nullptr;
   size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
 }
 template <typename T>
 void ForkList<T>::erase(const int &index) {
@@ -163,11 +236,17 @@ void ForkList<T>::erase(const int &index) {
   for (int i = 0; i < index - 1; ++i) {
     curr = curr->next;
   }
+  stats::walk(index);
   Node *temp       = curr->next;
   curr->next       = curr->next->next;
   curr->next->prev = curr;
   delete temp;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
   --size;
+  if (value_index != nullptr) {
+    RebuildIndex();  // every later position moved
+  }
 }
 template <typename T>
 void ForkList<T>::clear() {
@@ -184,6 +263,9 @@ void ForkList<T>::ResetAll(const T &value) {
     curr->data = value;
     curr       = curr->next;
   }
+  if (value_index != nullptr) {
+    RebuildIndex();
+  }
 }
 template <typename T>
 void ForkList<T>::echo() const {
@@ -196,6 +278,14 @@ void ForkList<T>::echo() const {
   cout << "\b\b  \b\b" << endl;
   cout << endl;
 }
+// export_to
+template <typename T>
+void ForkList<T>::export_to(ForkExport &out) const {
+  for (Node *curr = head; curr != nullptr; curr = curr->next) {
+    out.add(curr->data);
+  }
+  out.end_record();
+}
 template <typename T>
 [[maybe_unused]] void ForkList<T>::GetElement(const int &index) {
   if (index < 0 || index >= size) {
@@ -205,6 +295,7 @@ template <typename T>
   for (int i = 0; i < index; ++i) {
     curr = curr->next;
   }
+  stats::walk(index);
   cout << "element " << index << ": " << curr->data << endl;
 }
 template <typename T>
@@ -216,22 +307,120 @@ void ForkList<T>::SetElement(const int &index, const T &value) {
   for (int i = 0; i < index; ++i) {
     curr = curr->next;
   }
+  stats::walk(index);
+  if (value_index != nullptr) {
+    value_index->replace(index, curr->data, value);
+  }
   curr->data = value;
 }
 template <typename T>
 int ForkList<T>::GetIndex(const T &value) const {
+  if (value_index != nullptr) {
+    return value_index->first(value);
+  }
   Node *curr = head;
   int index  = 0;
   while (curr != nullptr) {
     if (curr->data == value) {
+      stats::walk(index + 1);
       return index;
     }
     curr = curr->next;
     ++index;
   }
+  stats::walk(index);
   return -1;
 }
 template <typename T>
+void ForkList<T>::unlink(Node *node) {
+  bool middle = node != head && node != tail;
+  if (value_index != nullptr && !middle) {
+    if (node == head) {
+      value_index->pop_front(node->data);
+    } else {
+      value_index->pop_back(node->data);
+    }
+  }
+  if (node->prev != nullptr) {
+    node->prev->next = node->next;
+  } else {
+    head = node->next;
+  }
+  if (node->next != nullptr) {
+    node->next->prev = node->prev;
+  } else {
+    tail = node->prev;
+  }
+  node->prev = nullptr;
+  node->next = nullptr;
+  --size;
+  if (value_index != nullptr && middle) {
+    RebuildIndex();  // every later position moved
+  }
+}
+template <typename T>
+void ForkList<T>::link_front(Node *node) {
+  node->prev = nullptr;
+  node->next = head;
+  if (head != nullptr) {
+    head->prev = node;
+  }
+  head = node;
+  if (tail == nullptr) {
+    tail = node;
+  }
+  if (value_index != nullptr) {
+    value_index->push_front(node->data);
+  }
+  ++size;
+  stats::shape(size, size);
+}
+template <typename T>
+void ForkList<T>::move_to_front(decltype(head) node) {
+  if (node == head) {
+    return;
+  }
+  unlink(node);
+  link_front(node);
+}
+template <typename T>
+void ForkList<T>::splice_front(ForkList &from, decltype(head) node) {
+  from.unlink(node);
+  link_front(node);
+}
+template <typename T>
+void ForkList<T>::erase_node(decltype(head) node) {
+  unlink(node);
+  delete node;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
+}
+template <typename T>
+void ForkList<T>::EnableIndex(const int &bloom_bits) {
+  delete value_index;
+  value_index = new ForkValueIndex<T>(bloom_bits);
+  RebuildIndex();
+}
+template <typename T>
+void ForkList<T>::DisableIndex() {
+  delete value_index;
+  value_index = nullptr;
+}
+template <typename T>
+void ForkList<T>::RebuildIndex() {
+  if (value_index == nullptr) {
+    return;
+  }
+  value_index->clear();
+  for (Node *curr = head; curr != nullptr; curr = curr->next) {
+    value_index->push_back(curr->data);
+  }
+}
+template <typename T>
+bool ForkList<T>::IsIndexed() const {
+  return value_index != nullptr;
+}
+template <typename T>
 auto ForkList<T>::data_head() -> decltype(head) {
   if (head == nullptr) {
     return nullptr;
@@ -246,6 +435,14 @@ auto ForkList<T>::data_tail() -> decltype(tail) {
   return tail;
 }
 template <typename T>
+auto ForkList<T>::data_head() const -> const Node * {
+  return head;
+}
+template <typename T>
+auto ForkList<T>::data_tail() const -> const Node * {
+  return tail;
+}
+template <typename T>
 auto ForkList<T>::data_at(const int &index) -> decltype(head) {
   if (index < 0 || index >= size) {
     throw std::out_of_range("index out of range");
@@ -254,9 +451,60 @@ auto ForkList<T>::data_at(const int &index) -> decltype(head) {
   for (int i = 0; i < index; ++i) {
     curr = curr->next;
   }
+  stats::walk(index);
   return curr;
 }
 
+// chain handoff (ForkChain.hpp)
+template <typename T>
+ForkList<T>::ForkList(ForkChain<T> &&chain) {
+  head = chain.data_head();
+  tail = chain.data_tail();
+  size = chain.get_size();
+  chain.release();
+  stats::adopt(size * static_cast<long long>(sizeof(Node)), size);
+  stats::shape(size, size);
+}
+template <typename T>
+template <ForkChainSource<T> Source>
+ForkList<T>::ForkList(Source &&from) : ForkList(from.release_chain()) {}
+template <typename T>
+ForkChain<T> ForkList<T>::release_chain() {
+  ForkChain<T> chain(head, tail, size);
+  stats::adopt(-size * static_cast<long long>(sizeof(Node)), -size);
+  head = nullptr;
+  tail = nullptr;
+  size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
+  return chain;
+}
+template <typename T>
+void ForkList<T>::splice_back(ForkChain<T> &&chain) {
+  if (chain.is_empty()) {
+    return;
+  }
+  Node *first = chain.data_head();
+  Node *last  = chain.data_tail();
+  int count   = chain.get_size();
+  chain.release();
+  stats::adopt(count * static_cast<long long>(sizeof(Node)), count);
+  if (tail == nullptr) {
+    head = first;
+  } else {
+    tail->next  = first;
+    first->prev = tail;
+  }
+  tail = last;
+  if (value_index != nullptr) {
+    for (Node *curr = first; curr != nullptr; curr = curr->next) {
+      value_index->push_back(curr->data);
+    }
+  }
+  size += count;
+  stats::shape(size, size);
+}
 template <typename T>
 T &ForkList<T>::operator[](const int &index) {
   if (index < 0 || index >= size) {
@@ -266,6 +514,7 @@ T &ForkList<T>::operator[](const int &index) {
   for (int i = 0; i < index; ++i) {
     curr = curr->next;
   }
+  stats::walk(index);
   return curr->data;
 }
 template <typename T>
@@ -273,12 +522,16 @@ ForkList<T> &ForkList<T>::operator=(const ForkList &other) {
   if (this == &other) {
     return *this;
   }
+  DisableIndex();  // the index follows the contents
   erase();
   Node *curr = other.head;
   while (curr != nullptr) {
     push_back(curr->data);
     curr = curr->next;
   }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
+  }
   return *this;
 }
 template <typename T>
@@ -287,14 +540,17 @@ ForkList<T> &ForkList<T>::operator=(ForkList &&other) noexcept {
     return *this;
   }
   erase();
-  head          = other.head;
-  tail          = other.tail;
-  size          = other.size;
-  current       = other.current;
-  other.head    = nullptr;
-  other.tail    = nullptr;
-  other.size    = 0;
-  other.current = 0;
+  delete value_index;
+  head              = other.head;
+  tail              = other.tail;
+  size              = other.size;
+  current           = other.current;
+  value_index       = other.value_index;
+  other.head        = nullptr;
+  other.tail        = nullptr;
+  other.size        = 0;
+  other.current     = 0;
+  other.value_index = nullptr;
   return *this;
 }
 template <typename T>
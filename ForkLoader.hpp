@@ -0,0 +1,337 @@
+// parallel bulk loading of a ForkVector from a file (POSIX only)
+// text:   numbers separated by whitespace or commas, parsed with from_chars
+// binary: a raw array of T in host byte order
+//
+// the file is cut into one byte range per thread. text is handled in two
+// passes over the ranges, count then parse, so the vector is resized once
+// and every thread writes its numbers straight into place. binary ranges
+// are pread() directly into the vector storage. loaded elements are
+// appended after the current ones
+//
+/*
+ *  file:   [ chunk 0 | chunk 1 | chunk 2 | chunk 3 ]
+ *  count:      c0        c1        c2        c3
+ *  vector: [ old | c0 ... | c1 ... | c2 ... | c3 ... ]
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+#include "ForkVector.hpp"
+
+enum class ForkLoadRead {
+  mmap,   // map the whole file, the kernel reads ahead sequentially
+  pread,  // each thread preads its own range into a private buffer
+};
+
+class ForkLoadOptions {
+public:
+  int threads          = 0;        // 0 = std::thread::hardware_concurrency()
+  long long min_chunk  = 1 << 20;  // never split the file finer than this
+  ForkLoadRead read    = ForkLoadRead::mmap;  // text only, binary uses pread
+  int max_number_width = 128;  // longest token accepted across a chunk end
+};
+
+class ForkLoader {
+private:
+  class File {
+  public:
+    int fd         = -1;
+    long long size = 0;
+    explicit File(const std::string &path);
+    ~File();
+    File(const File &other)            = delete;
+    File &operator=(const File &other) = delete;
+  };
+
+  // one range of the file and the bytes visible to its thread
+  class Chunk {
+  public:
+    long long begin      = 0;  // first byte owned by this chunk
+    long long end        = 0;  // one past the last byte owned
+    const char *data     = nullptr;  // data[0] is file byte data_begin
+    long long data_begin = 0;
+    long long data_end   = 0;
+    long long count      = 0;  // numbers starting inside [begin, end)
+    ForkVector<char> buffer;   // backing store in pread mode
+  };
+
+  static bool is_separator(const char &c);
+  static int thread_count(const long long &bytes,
+                          const ForkLoadOptions &options);
+  static void read_fully(const int &fd, char *dst, long long bytes,
+                         long long offset);
+  template <typename F>
+  static void parallel(const int &n, F body);  // body(i) on n threads
+  static void count_numbers(Chunk &chunk);
+  template <typename T>
+  static void parse_numbers(const Chunk &chunk, const long long &file_size,
+                            T *out);
+
+public:
+  template <typename T>
+  static void load_text(const std::string &path, ForkVector<T> &vec,
+                        const ForkLoadOptions &options = ForkLoadOptions());
+  template <typename T>
+  static void load_binary(const std::string &path, ForkVector<T> &vec,
+                          const ForkLoadOptions &options = ForkLoadOptions());
+};
+
+// File
+inline ForkLoader::File::File(const std::string &path) {
+  fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat info {};
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    int error = errno;
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::system_error(error, std::generic_category(),
+                            "cannot open " + path);
+  }
+  size = info.st_size;
+}
+inline ForkLoader::File::~File() {
+  close(fd);
+}
+
+// is_separator
+inline bool ForkLoader::is_separator(const char &c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',';
+}
+// thread_count
+inline int ForkLoader::thread_count(const long long &bytes,
+                                    const ForkLoadOptions &options) {
+  long long n = options.threads;
+  if (n <= 0) {
+    n = std::thread::hardware_concurrency();
+  }
+  long long by_size = bytes / std::max(options.min_chunk, 1LL);
+  n                 = std::min(n, std::max(by_size, 1LL));
+  return static_cast<int>(std::max(n, 1LL));
+}
+// read_fully (retries short reads, a premature end of file is an error)
+inline void ForkLoader::read_fully(const int &fd, char *dst, long long bytes,
+                                   long long offset) {
+  while (bytes > 0) {
+    ssize_t n = pread(fd, dst, static_cast<size_t>(bytes), offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      throw std::system_error(errno, std::generic_category(), "pread");
+    }
+    if (n == 0) {
+      throw std::runtime_error("file shrank while loading");
+    }
+    dst += n;
+    bytes -= n;
+    offset += n;
+  }
+}
+// parallel (the calling thread runs body(0), the first exception wins)
+template <typename F>
+void ForkLoader::parallel(const int &n, F body) {
+  ForkVector<std::exception_ptr> errors;
+  errors.resize(n);
+  ForkVector<std::thread *> threads;
+  auto guarded = [&errors, &body](int i) {
+    try {
+      body(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  for (int i = 1; i < n; i++) {
+    threads.push_back(new std::thread(guarded, i));
+  }
+  guarded(0);
+  for (int i = 0; i < threads.GetSize(); i++) {
+    threads[i]->join();
+    delete threads[i];
+  }
+  for (int i = 0; i < n; i++) {
+    if (errors[i]) {
+      std::rethrow_exception(errors[i]);
+    }
+  }
+}
+// count_numbers (a number belongs to the chunk its first byte is in)
+inline void ForkLoader::count_numbers(Chunk &chunk) {
+  const char *base = chunk.data - chunk.data_begin;
+  bool prev_sep    = chunk.begin == 0 || is_separator(base[chunk.begin - 1]);
+  long long count  = 0;
+  for (long long pos = chunk.begin; pos < chunk.end; pos++) {
+    bool sep = is_separator(base[pos]);
+    if (!sep && prev_sep) {
+      ++count;
+    }
+    prev_sep = sep;
+  }
+  chunk.count = count;
+}
+// parse_numbers
+template <typename T>
+void ForkLoader::parse_numbers(const Chunk &chunk, const long long &file_size,
+                               T *out) {
+  const char *base = chunk.data - chunk.data_begin;
+  const char *last = base + chunk.data_end;
+  long long pos    = chunk.begin;
+  if (pos > 0 && !is_separator(base[pos - 1])) {
+    while (pos < chunk.end && !is_separator(base[pos])) {
+      ++pos;  // tail of a number owned by the previous chunk
+    }
+  }
+  for (long long done = 0; done < chunk.count; done++) {
+    while (is_separator(base[pos])) {
+      ++pos;
+    }
+    const char *first = base + pos;
+    if (*first == '+') {
+      ++first;  // from_chars does not take a leading plus
+    }
+    auto [ptr, ec] = std::from_chars(first, last, *out++);
+    if (ec != std::errc() || (ptr != last && !is_separator(*ptr))) {
+      throw std::invalid_argument("malformed number at byte " +
+                                  std::to_string(pos));
+    }
+    if (ptr == last && chunk.data_end < file_size) {
+      throw std::invalid_argument("number too long at byte " +
+                                  std::to_string(pos));
+    }
+    pos = ptr - base;
+  }
+}
+
+// load_text
+template <typename T>
+void ForkLoader::load_text(const std::string &path, ForkVector<T> &vec,
+                           const ForkLoadOptions &options) {
+  static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                "load_text needs a numeric element type");
+  File file(path);
+  if (file.size == 0) {
+    return;
+  }
+  int n = thread_count(file.size, options);
+  if (options.read == ForkLoadRead::pread) {
+    // a private buffer is a ForkVector<char>, so no range may pass INT_MAX
+    long long widest = INT_MAX - 1LL - options.max_number_width;
+    if ((file.size + n - 1) / n > widest) {
+      n = static_cast<int>((file.size + widest - 1) / widest);
+    }
+  }
+  ForkVector<Chunk> chunks;
+  chunks.resize(n);
+  void *map = MAP_FAILED;
+  if (options.read == ForkLoadRead::mmap) {
+    map = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+    if (map == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    madvise(map, file.size, MADV_SEQUENTIAL);
+  } else {
+    posix_fadvise(file.fd, 0, file.size, POSIX_FADV_SEQUENTIAL);
+  }
+  int old_size = vec.GetSize();
+  try {
+    // pass 1: fetch the bytes of each range and count its numbers
+    parallel(n, [&](int i) {
+      Chunk &chunk = chunks[i];
+      chunk.begin  = file.size * i / n;
+      chunk.end    = file.size * (i + 1) / n;
+      if (map != MAP_FAILED) {
+        chunk.data       = static_cast<const char *>(map);
+        chunk.data_begin = 0;
+        chunk.data_end   = file.size;
+      } else {
+        // one byte before, to see whether a number starts at begin, and
+        // enough after to finish the last number that starts before end
+        chunk.data_begin = std::max(chunk.begin - 1, 0LL);
+        chunk.data_end =
+            std::min(chunk.end + options.max_number_width, file.size);
+        long long bytes = chunk.data_end - chunk.data_begin;
+        chunk.buffer.resize(static_cast<int>(bytes));
+        read_fully(file.fd, chunk.buffer.GetPtr(), bytes, chunk.data_begin);
+        chunk.data = chunk.buffer.GetPtr();
+      }
+      count_numbers(chunk);
+    });
+    // size the vector once, each chunk writes from its own offset
+    ForkVector<long long> offsets;
+    offsets.resize(n);
+    long long total = vec.GetSize();
+    for (int i = 0; i < n; i++) {
+      offsets[i] = total;
+      total += chunks[i].count;
+    }
+    if (total > INT_MAX) {
+      throw std::length_error("too many numbers for ForkVector");
+    }
+    vec.resize(static_cast<int>(total));
+    // pass 2: parse straight into place
+    T *out = vec.GetPtr();
+    parallel(n, [&](int i) {
+      parse_numbers(chunks[i], file.size, out + offsets[i]);
+    });
+  } catch (...) {
+    vec.resize(old_size);  // drop the slots of a failed parse
+    if (map != MAP_FAILED) {
+      munmap(map, file.size);
+    }
+    throw;
+  }
+  if (map != MAP_FAILED) {
+    munmap(map, file.size);
+  }
+}
+// load_binary
+template <typename T>
+void ForkLoader::load_binary(const std::string &path, ForkVector<T> &vec,
+                             const ForkLoadOptions &options) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "load_binary needs a trivially copyable element type");
+  File file(path);
+  if (file.size % static_cast<long long>(sizeof(T)) != 0) {
+    throw std::invalid_argument("file size is not a multiple of sizeof(T)");
+  }
+  long long count = file.size / static_cast<long long>(sizeof(T));
+  long long base  = vec.GetSize();
+  if (base + count > INT_MAX) {
+    throw std::length_error("too many elements for ForkVector");
+  }
+  if (count == 0) {
+    return;
+  }
+  posix_fadvise(file.fd, 0, file.size, POSIX_FADV_SEQUENTIAL);
+  vec.resize(static_cast<int>(base + count));
+  char *out       = reinterpret_cast<char *>(vec.GetPtr() + base);
+  int n           = thread_count(file.size, options);
+  long long width = sizeof(T);
+  try {
+    parallel(n, [&](int i) {
+      // split on element boundaries
+      long long first = count * i / n * width;
+      long long last  = count * (i + 1) / n * width;
+      read_fully(file.fd, out + first, last - first, first);
+    });
+  } catch (...) {
+    vec.resize(static_cast<int>(base));  // a short read loads nothing
+    throw;
+  }
+}
@@ -0,0 +1,426 @@
+// compressed integer vector: frame of reference or delta, then bit-packing
+// values are appended to a plain tail of 128; a full tail is encoded as one
+// block, either as offsets from the block minimum (frame of reference) or,
+// when that is narrower, as consecutive differences offset by the smallest
+// one (delta, for sorted IDs), packed with as few bits as the widest needs.
+// sorted IDs and small counters shrink to a few bits per value
+//
+// the packing is vertical: value i of a block sits in lane i % 4, so one
+// SSE2 shift-and-mask decodes four values at a time (a portable loop with
+// the same layout elsewhere). offsets wider than 32 bits (64-bit values
+// only) are split into a low and a high plane
+//
+// GetElement(i) reads one value straight from a frame-of-reference block
+// and decodes a delta block into a local buffer, nothing shared is written,
+// so concurrent reads of a const vector are safe; scan() and
+// decode_block() decode whole blocks for sequential work
+
+/*
+ *  blocks: [ for, base 1000, 7 bits | delta, base 52, step 3, 2 bits | ... ]
+ *  words:  [ block 0: 4 * 7 words   | block 1: 4 * 2 words           | ... ]
+ *  tail:   [ v | v | v ]            appended, not yet encoded
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "ForkExport.hpp"
+#include "ForkStorage.hpp"
+#include "ForkVector.hpp"
+
+template <typename T>
+class ForkPackedVector {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                    sizeof(T) <= 8,
+                "packed values must be non-bool integers of at most 64 bits");
+
+public:
+  using value_type                = T;
+  static constexpr int block_size = 128;
+
+private:
+  using U    = std::make_unsigned_t<T>;
+  using S    = std::make_signed_t<T>;
+  using Word = std::uint32_t;
+
+  class Block {
+  public:
+    T base;      // minimum (frame of reference) or first value (delta)
+    T step;      // smallest difference, delta blocks only
+    int offset;  // first word in words
+    short bits;  // width of one packed offset, 0..64
+    bool delta;  // encoding
+  };
+
+  ForkVector<Block> blocks;
+  ForkVector<Word, ForkAlignedStorage<16>> words;  // 4 * bits per block
+  T tail[block_size];                              // not yet encoded
+  int tail_size = 0;
+
+  static int width(const std::uint64_t &range);
+  static void pack_plane(const Word *in, const int &bits, Word *out);
+  static void unpack_plane(const Word *in, const int &bits, Word *out);
+  static Word extract(const Word *in, const int &bits, const int &index);
+  void encode();  // tail -> one block
+  [[nodiscard]] T read(const int &block, const int &index) const;
+
+public:
+  // constructor and destructor
+  ForkPackedVector() = default;
+  explicit ForkPackedVector(const ForkVector<T> &plain);
+
+  // functions
+  void push_back(const T &value);
+  void pop_back();  // decodes the last block back into the tail if needed
+  void clear();     // clear [data_only]
+  void erase();     // erase [data & capacity]
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] bool is_empty() const;
+  [[nodiscard]] long long GetBytes() const;  // encoded size, headers included
+  [[nodiscard]] int GetBlockCount() const;   // including the tail
+  [[nodiscard]] T GetElement(const int &index) const;
+  int decode_block(const int &block, T *out) const;  // num of values
+  template <typename Visit>
+  void scan(Visit visit) const;  // visit(value) in order
+  [[nodiscard]] ForkVector<T> unpack() const;
+
+  // operator overloading
+  T operator[](const int &index) const;
+
+  // echo
+  void echo() const;
+  void export_to(ForkExport &out) const;  // append as one record
+};
+
+// width (bits needed for values up to range)
+template <typename T>
+int ForkPackedVector<T>::width(const std::uint64_t &range) {
+  return range == 0 ? 0 : 64 - std::countl_zero(range);
+}
+// pack_plane (128 values of `bits` bits -> 4 * bits words)
+template <typename T>
+void ForkPackedVector<T>::pack_plane(const Word *in, const int &bits,
+                                     Word *out) {
+  for (int i = 0; i < 4 * bits; i++) {
+    out[i] = 0;
+  }
+  if (bits == 0) {
+    return;  // every offset is 0, nothing is stored
+  }
+  for (int i = 0; i < block_size; i++) {
+    int lane  = i & 3;
+    int at    = (i >> 2) * bits;  // bit position within the lane
+    int word  = at >> 5;
+    int shift = at & 31;
+    out[word * 4 + lane] |= in[i] << shift;
+    if (shift + bits > 32) {
+      out[(word + 1) * 4 + lane] |= in[i] >> (32 - shift);
+    }
+  }
+}
+// unpack_plane (inverse of pack_plane, out must be 16-byte aligned)
+template <typename T>
+void ForkPackedVector<T>::unpack_plane(const Word *in, const int &bits,
+                                       Word *out) {
+  if (bits == 0) {
+    for (int i = 0; i < block_size; i++) {
+      out[i] = 0;
+    }
+    return;
+  }
+  Word mask = bits == 32 ? ~Word(0) : (Word(1) << bits) - 1;
+#if defined(__SSE2__)
+  const __m128i lanes_mask = _mm_set1_epi32(static_cast<int>(mask));
+  for (int j = 0; j < block_size / 4; j++) {
+    int at         = j * bits;
+    int word       = at >> 5;
+    int shift      = at & 31;
+    const auto *lo = reinterpret_cast<const __m128i *>(in + word * 4);
+    __m128i v = _mm_srl_epi32(_mm_load_si128(lo), _mm_cvtsi32_si128(shift));
+    if (shift + bits > 32) {
+      __m128i hi = _mm_sll_epi32(_mm_load_si128(lo + 1),
+                                 _mm_cvtsi32_si128(32 - shift));
+      v          = _mm_or_si128(v, hi);
+    }
+    _mm_store_si128(reinterpret_cast<__m128i *>(out + j * 4),
+                    _mm_and_si128(v, lanes_mask));
+  }
+#else
+  for (int j = 0; j < block_size / 4; j++) {
+    int at    = j * bits;
+    int word  = at >> 5;
+    int shift = at & 31;
+    for (int lane = 0; lane < 4; lane++) {
+      Word v = in[word * 4 + lane] >> shift;
+      if (shift + bits > 32) {
+        v |= in[(word + 1) * 4 + lane] << (32 - shift);
+      }
+      out[j * 4 + lane] = v & mask;
+    }
+  }
+#endif
+}
+// extract (one value of a packed plane)
+template <typename T>
+typename ForkPackedVector<T>::Word ForkPackedVector<T>::extract(
+    const Word *in, const int &bits, const int &index) {
+  if (bits == 0) {
+    return 0;
+  }
+  int lane  = index & 3;
+  int at    = (index >> 2) * bits;
+  int word  = at >> 5;
+  int shift = at & 31;
+  Word v    = in[word * 4 + lane] >> shift;
+  if (shift + bits > 32) {
+    v |= in[(word + 1) * 4 + lane] << (32 - shift);
+  }
+  return bits == 32 ? v : v & ((Word(1) << bits) - 1);
+}
+// encode (frame of reference or delta, whichever packs narrower)
+template <typename T>
+void ForkPackedVector<T>::encode() {
+  T low  = tail[0];
+  T high = tail[0];
+  S step = 0;
+  S top  = 0;
+  for (int i = 0; i < block_size; i++) {
+    low  = tail[i] < low ? tail[i] : low;
+    high = tail[i] > high ? tail[i] : high;
+    if (i > 0) {
+      S diff = static_cast<S>(static_cast<U>(tail[i]) - U(tail[i - 1]));
+      step   = i == 1 || diff < step ? diff : step;
+      top    = i == 1 || diff > top ? diff : top;
+    }
+  }
+  int for_bits   = width(static_cast<U>(static_cast<U>(high) - U(low)));
+  int delta_bits = width(static_cast<U>(static_cast<U>(top) - U(step)));
+
+  Block block;
+  block.delta  = delta_bits < for_bits;
+  block.bits   = static_cast<short>(block.delta ? delta_bits : for_bits);
+  block.base   = block.delta ? tail[0] : low;
+  block.step   = block.delta ? static_cast<T>(step) : T(0);
+  block.offset = words.GetSize();
+  alignas(16) Word plane[block_size];
+  std::uint64_t offsets[block_size];
+  for (int i = 0; i < block_size; i++) {
+    U from     = !block.delta ? U(low)
+                 : i == 0     ? U(tail[0])
+                              : static_cast<U>(U(tail[i - 1]) + U(step));
+    offsets[i] = static_cast<U>(static_cast<U>(tail[i]) - from);
+  }
+  int low_bits  = block.bits < 32 ? block.bits : 32;
+  int high_bits = block.bits - low_bits;
+  int needed    = block.offset + 4 * block.bits;
+  if (needed > words.GetCapacity()) {  // grow by doubling, resize is exact
+    int doubled = 2 * words.GetCapacity();
+    words.preAlloc(needed > doubled ? needed : doubled);
+  }
+  words.resize(needed);
+  for (int i = 0; i < block_size; i++) {
+    plane[i] = static_cast<Word>(offsets[i]);
+  }
+  pack_plane(plane, low_bits, words.GetPtr() + block.offset);
+  if (high_bits > 0) {
+    for (int i = 0; i < block_size; i++) {
+      plane[i] = static_cast<Word>(offsets[i] >> 32);
+    }
+    pack_plane(plane, high_bits, words.GetPtr() + block.offset + 4 * low_bits);
+  }
+  blocks.push_back(block);
+  tail_size = 0;
+}
+// read (one value of an encoded block)
+template <typename T>
+T ForkPackedVector<T>::read(const int &block, const int &index) const {
+  const Block &header = blocks.GetPtr()[block];
+  if (header.delta) {
+    T values[block_size];  // local, so concurrent const reads share nothing
+    decode_block(block, values);
+    return values[index];
+  }
+  const Word *plane    = words.GetPtr() + header.offset;
+  int low_bits         = header.bits < 32 ? header.bits : 32;
+  std::uint64_t offset = extract(plane, low_bits, index);
+  if (header.bits > 32) {
+    offset |= std::uint64_t(extract(plane + 4 * low_bits, header.bits - 32,
+                                    index))
+              << 32;
+  }
+  return static_cast<T>(static_cast<U>(U(header.base) + offset));
+}
+
+// constructor
+template <typename T>
+ForkPackedVector<T>::ForkPackedVector(const ForkVector<T> &plain) {
+  for (int i = 0; i < plain.GetSize(); i++) {
+    push_back(plain.GetPtr()[i]);
+  }
+}
+
+// push_back
+template <typename T>
+void ForkPackedVector<T>::push_back(const T &value) {
+  tail[tail_size++] = value;
+  if (tail_size == block_size) {
+    encode();
+  }
+}
+// pop_back
+template <typename T>
+void ForkPackedVector<T>::pop_back() {
+  if (tail_size == 0) {
+    if (blocks.GetSize() == 0) {
+      return;
+    }
+    int last = blocks.GetSize() - 1;
+    decode_block(last, tail);
+    words.resize(blocks.GetPtr()[last].offset);
+    blocks.pop_back();
+    tail_size = block_size;
+  }
+  --tail_size;
+}
+// clear all
+template <typename T>
+void ForkPackedVector<T>::clear() {
+  blocks.clear();
+  words.clear();
+  tail_size = 0;
+}
+// erase all
+template <typename T>
+void ForkPackedVector<T>::erase() {
+  blocks.erase();
+  words.erase();
+  tail_size = 0;
+}
+// get_size
+template <typename T>
+int ForkPackedVector<T>::GetSize() const {
+  return blocks.GetSize() * block_size + tail_size;
+}
+// is_empty
+template <typename T>
+bool ForkPackedVector<T>::is_empty() const {
+  return GetSize() == 0;
+}
+// get_bytes
+template <typename T>
+long long ForkPackedVector<T>::GetBytes() const {
+  return static_cast<long long>(words.GetSize()) * sizeof(Word) +
+         static_cast<long long>(blocks.GetSize()) * sizeof(Block) +
+         static_cast<long long>(tail_size) * sizeof(T);
+}
+// get_block_count
+template <typename T>
+int ForkPackedVector<T>::GetBlockCount() const {
+  return blocks.GetSize() + (tail_size > 0 ? 1 : 0);
+}
+// get_element
+template <typename T>
+T ForkPackedVector<T>::GetElement(const int &index) const {
+  return (*this)[index];
+}
+// decode_block (the last block may be the partial tail)
+template <typename T>
+int ForkPackedVector<T>::decode_block(const int &block, T *out) const {
+  if (block == blocks.GetSize() && tail_size > 0) {
+    for (int i = 0; i < tail_size; i++) {
+      out[i] = tail[i];
+    }
+    return tail_size;
+  }
+  if (block < 0 || block >= blocks.GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  const Block &header = blocks.GetPtr()[block];
+  const Word *plane   = words.GetPtr() + header.offset;
+  int low_bits        = header.bits < 32 ? header.bits : 32;
+  alignas(16) Word low[block_size];
+  unpack_plane(plane, low_bits, low);
+  U base = U(header.base);
+  U step = U(header.step);
+  if (header.bits <= 32) {
+    if (header.delta) {
+      U value = base - step;
+      for (int i = 0; i < block_size; i++) {
+        value += step + low[i];
+        out[i] = static_cast<T>(value);
+      }
+    } else {
+      for (int i = 0; i < block_size; i++) {
+        out[i] = static_cast<T>(static_cast<U>(base + low[i]));
+      }
+    }
+    return block_size;
+  }
+  alignas(16) Word high[block_size];
+  unpack_plane(plane + 4 * low_bits, header.bits - 32, high);
+  U value = base - step;
+  for (int i = 0; i < block_size; i++) {
+    U offset = static_cast<U>(std::uint64_t(high[i]) << 32 | low[i]);
+    value    = header.delta ? value + step + offset : base + offset;
+    out[i]   = static_cast<T>(value);
+  }
+  return block_size;
+}
+// scan
+template <typename T>
+template <typename Visit>
+void ForkPackedVector<T>::scan(Visit visit) const {
+  T buffer[block_size];
+  for (int b = 0; b < GetBlockCount(); b++) {
+    int n = decode_block(b, buffer);
+    for (int i = 0; i < n; i++) {
+      visit(buffer[i]);
+    }
+  }
+}
+// unpack all
+template <typename T>
+ForkVector<T> ForkPackedVector<T>::unpack() const {
+  ForkVector<T> plain;
+  plain.resize(GetSize());
+  for (int b = 0; b < GetBlockCount(); b++) {
+    decode_block(b, plain.GetPtr() + b * block_size);
+  }
+  return plain;
+}
+
+// operator []
+template <typename T>
+T ForkPackedVector<T>::operator[](const int &index) const {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  int block = index / block_size;
+  if (block == blocks.GetSize()) {
+    return tail[index % block_size];
+  }
+  return read(block, index % block_size);
+}
+
+// echo
+template <typename T>
+void ForkPackedVector<T>::echo() const {
+  std::cout << "current packed vector: ";
+  scan([](const T &value) { std::cout << value << ", "; });
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+// export_to
+template <typename T>
+void ForkPackedVector<T>::export_to(ForkExport &out) const {
+  scan([&out](const T &value) { out.add(value); });
+  out.end_record();
+}
@@ -0,0 +1,139 @@
+// hardware performance counters around a measured region (Linux only)
+// wraps perf_event_open: cycles, instructions, L1d / LLC / dTLB read misses
+// and branch misses of the calling thread, user space only
+//
+// counters the kernel refuses (no PMU in a VM, perf_event_paranoid too
+// high, ...) are reported as -1, everything else keeps working
+
+#pragma once
+
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#endif
+
+class ForkPerfCounters {
+public:
+  static constexpr int count = 6;
+  static constexpr const char *names[count] = {
+      "cycles",     "instructions",  "l1d_misses",
+      "llc_misses", "branch_misses", "dtlb_misses"};
+
+private:
+  int fds[count];
+
+public:
+  // constructor and destructor
+  ForkPerfCounters();
+  ~ForkPerfCounters();
+  ForkPerfCounters(const ForkPerfCounters &other)            = delete;
+  ForkPerfCounters &operator=(const ForkPerfCounters &other) = delete;
+
+  [[nodiscard]] bool available() const;  // at least one counter opened
+  void start();                          // reset and enable all counters
+  void stop(long long values[count]);    // disable and read, -1 = missing
+};
+
+#ifdef __linux__
+
+// constructor
+inline ForkPerfCounters::ForkPerfCounters() {
+  auto cache = [](const std::uint64_t &cache_id) {
+    return cache_id | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  };
+  const std::uint32_t types[count] = {
+      PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+      PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+  const std::uint64_t configs[count] = {
+      PERF_COUNT_HW_CPU_CYCLES,       PERF_COUNT_HW_INSTRUCTIONS,
+      cache(PERF_COUNT_HW_CACHE_L1D), cache(PERF_COUNT_HW_CACHE_LL),
+      PERF_COUNT_HW_BRANCH_MISSES,    cache(PERF_COUNT_HW_CACHE_DTLB)};
+  for (int i = 0; i < count; i++) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = types[i];
+    attr.config         = configs[i];
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    // scale by enabled / running time when the PMU multiplexes counters
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fds[i] = static_cast<int>(
+        syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+}
+// destructor
+inline ForkPerfCounters::~ForkPerfCounters() {
+  for (int i = 0; i < count; i++) {
+    if (fds[i] >= 0) {
+      close(fds[i]);
+    }
+  }
+}
+// available
+inline bool ForkPerfCounters::available() const {
+  for (int i = 0; i < count; i++) {
+    if (fds[i] >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+// start
+inline void ForkPerfCounters::start() {
+  for (int i = 0; i < count; i++) {
+    if (fds[i] >= 0) {
+      ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+// stop
+inline void ForkPerfCounters::stop(long long values[count]) {
+  for (int i = 0; i < count; i++) {
+    if (fds[i] >= 0) {
+      ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  for (int i = 0; i < count; i++) {
+    values[i] = -1;
+    std::uint64_t raw[3];  // value, time enabled, time running
+    if (fds[i] < 0 || read(fds[i], raw, sizeof(raw)) != sizeof(raw)) {
+      continue;
+    }
+    if (raw[2] == 0) {
+      continue;  // never got scheduled onto the PMU
+    }
+    double scale = static_cast<double>(raw[1]) / static_cast<double>(raw[2]);
+    values[i]    = static_cast<long long>(static_cast<double>(raw[0]) * scale);
+  }
+}
+
+#else
+
+inline ForkPerfCounters::ForkPerfCounters() {
+  for (int i = 0; i < count; i++) {
+    fds[i] = -1;
+  }
+}
+inline ForkPerfCounters::~ForkPerfCounters() = default;
+inline bool ForkPerfCounters::available() const {
+  return false;
+}
+inline void ForkPerfCounters::start() {}
+inline void ForkPerfCounters::stop(long long values[count]) {
+  for (int i = 0; i < count; i++) {
+    values[i] = -1;
+  }
+}
+
+#endif
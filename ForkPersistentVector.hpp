@@ -0,0 +1,519 @@
+// persistent (immutable) vector with structural sharing
+// a 32-way radix-balanced tree plus a tail leaf of up to 32 elements:
+// copies share every node and cost O(1), an update copies only the
+// O(log32 n) nodes on the path to the element, old versions stay readable
+//
+// nodes are reference counted (atomically, so snapshots may be read on other
+// threads); an edit works in place on nodes nobody else holds and copies the
+// rest, which is what makes ForkTransientVector cheap for batch edits: the
+// first write to a path copies it, later writes to it are in place
+
+/*
+ *  root (shift 10)          tail
+ *    [ . | . | ... ]        [ 2048 .. 2079 ]
+ *     /     \
+ *  [ . ... ] [ . ... ]      leaves of 32 elements
+ */
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkStats.hpp"
+#include "ForkVector.hpp"
+
+template <typename T>
+class ForkTransientVector;
+
+template <typename T>
+class ForkPersistentVector {
+public:
+  using value_type                = T;
+  static constexpr int bits       = 5;
+  static constexpr int width      = 1 << bits;  // 32 children per node
+  static constexpr int index_mask = width - 1;
+
+private:
+  friend class ForkTransientVector<T>;
+  using stats = ForkStatsOf<ForkPersistentVector>;
+
+  class Node {
+  public:
+    std::atomic<int> refs{1};
+    bool leaf;
+    explicit Node(const bool &leaf) : leaf(leaf) {}
+  };
+  class Branch : public Node {
+  public:
+    Node *child[width] = {};
+    Branch() : Node(false) {}
+  };
+  class Leaf : public Node {
+  public:
+    T values[width];
+    Leaf() : Node(true) {}
+  };
+
+  Node *root = nullptr;  // nullptr while everything fits in the tail
+  Leaf *tail = nullptr;
+  int size   = 0;
+  int shift  = bits;  // the root's children are indexed by (i >> shift)
+
+  static void retain(Node *node);
+  static void release(Node *node);
+  static Node *clone(Node *node);
+  static void own(Node *&slot);  // make slot safe to edit in place
+  static void own(Leaf *&slot);
+  static Node *new_path(const int &level, Node *leaf);
+  [[nodiscard]] int tail_offset() const;
+  Leaf *leaf_for(const int &index) const;
+  void push_tail(Node *&slot, const int &level, Node *leaf);
+  bool pop_tail(Node *&slot, const int &level);
+
+  // in-place edits (copy on write for shared nodes)
+  void push_in_place(const T &value);
+  void set_in_place(const int &index, const T &value);
+  void pop_in_place();
+
+public:
+  // constructor and destructor
+  ForkPersistentVector() = default;
+  explicit ForkPersistentVector(const ForkVector<T> &vec);
+  ~ForkPersistentVector();
+  ForkPersistentVector(const ForkPersistentVector &other);  // O(1)
+  ForkPersistentVector(ForkPersistentVector &&other) noexcept;
+
+  // functions (each update returns a new version, *this is unchanged)
+  [[nodiscard]] ForkPersistentVector push_back(const T &value) const;
+  [[nodiscard]] ForkPersistentVector pop_back() const;
+  [[nodiscard]] ForkPersistentVector SetElement(const int &index,
+                                                const T &value) const;
+  [[nodiscard]] ForkTransientVector<T> transient() const;
+  [[nodiscard]] const T &GetElement(const int &index) const;
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] bool is_empty() const;
+
+  // operator overloading
+  const T &operator[](const int &index) const;
+  ForkPersistentVector &operator=(const ForkPersistentVector &other);
+  ForkPersistentVector &operator=(ForkPersistentVector &&other) noexcept;
+
+  // echo
+  void echo() const;
+};
+
+// batch editing for a ForkPersistentVector: mutating calls, no new version
+// per call; persistent() hands out an O(1) snapshot and editing may go on
+template <typename T>
+class ForkTransientVector {
+public:
+  using value_type = T;
+
+private:
+  ForkPersistentVector<T> vec;
+
+public:
+  // constructor and destructor
+  ForkTransientVector() = default;
+  explicit ForkTransientVector(const ForkPersistentVector<T> &base);
+
+  // functions
+  void push_back(const T &value);
+  void pop_back();
+  void SetElement(const int &index, const T &value);
+  [[nodiscard]] const T &GetElement(const int &index) const;
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] ForkPersistentVector<T> persistent() const;
+};
+
+// retain
+template <typename T>
+void ForkPersistentVector<T>::retain(Node *node) {
+  if (node != nullptr) {
+    node->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+// release (the last owner frees the node and drops its children)
+template <typename T>
+void ForkPersistentVector<T>::release(Node *node) {
+  if (node == nullptr ||
+      node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  if (node->leaf) {
+    delete static_cast<Leaf *>(node);
+    stats::release(sizeof(Leaf));
+    return;
+  }
+  auto *branch = static_cast<Branch *>(node);
+  for (Node *child : branch->child) {
+    release(child);
+  }
+  delete branch;
+  stats::release(sizeof(Branch));
+}
+// clone
+template <typename T>
+typename ForkPersistentVector<T>::Node *ForkPersistentVector<T>::clone(
+    Node *node) {
+  if (node->leaf) {
+    auto *copy = new Leaf;
+    stats::allocate(sizeof(Leaf));
+    for (int i = 0; i < width; i++) {
+      copy->values[i] = static_cast<Leaf *>(node)->values[i];
+    }
+    return copy;
+  }
+  auto *copy = new Branch;
+  stats::allocate(sizeof(Branch));
+  for (int i = 0; i < width; i++) {
+    copy->child[i] = static_cast<Branch *>(node)->child[i];
+    retain(copy->child[i]);
+  }
+  return copy;
+}
+// own (a node only this version holds may be edited in place)
+template <typename T>
+void ForkPersistentVector<T>::own(Node *&slot) {
+  if (slot->refs.load(std::memory_order_acquire) == 1) {
+    return;
+  }
+  Node *copy = clone(slot);
+  release(slot);
+  slot = copy;
+}
+template <typename T>
+void ForkPersistentVector<T>::own(Leaf *&slot) {
+  Node *node = slot;
+  own(node);
+  slot = static_cast<Leaf *>(node);
+}
+// new_path (a chain of single-child branches down to the leaf)
+template <typename T>
+typename ForkPersistentVector<T>::Node *ForkPersistentVector<T>::new_path(
+    const int &level, Node *leaf) {
+  if (level == 0) {
+    return leaf;
+  }
+  auto *branch = new Branch;
+  stats::allocate(sizeof(Branch));
+  branch->child[0] = new_path(level - bits, leaf);
+  return branch;
+}
+// tail_offset (index of the first element in the tail)
+template <typename T>
+int ForkPersistentVector<T>::tail_offset() const {
+  return size < width ? 0 : ((size - 1) >> bits) << bits;
+}
+// leaf_for
+template <typename T>
+typename ForkPersistentVector<T>::Leaf *ForkPersistentVector<T>::leaf_for(
+    const int &index) const {
+  if (index >= tail_offset()) {
+    return tail;
+  }
+  Node *node = root;
+  for (int level = shift; level > 0; level -= bits) {
+    node = static_cast<Branch *>(node)->child[(index >> level) & index_mask];
+  }
+  return static_cast<Leaf *>(node);
+}
+// push_tail (hang a full tail leaf into the tree)
+template <typename T>
+void ForkPersistentVector<T>::push_tail(Node *&slot, const int &level,
+                                        Node *leaf) {
+  own(slot);
+  auto *branch = static_cast<Branch *>(slot);
+  int sub      = ((size - 1) >> level) & index_mask;
+  if (level == bits) {
+    branch->child[sub] = leaf;
+  } else if (branch->child[sub] != nullptr) {
+    push_tail(branch->child[sub], level - bits, leaf);
+  } else {
+    branch->child[sub] = new_path(level - bits, leaf);
+  }
+}
+// pop_tail (drop the rightmost leaf, true if slot became empty)
+template <typename T>
+bool ForkPersistentVector<T>::pop_tail(Node *&slot, const int &level) {
+  own(slot);
+  auto *branch     = static_cast<Branch *>(slot);
+  int sub          = ((size - 2) >> level) & index_mask;
+  bool child_empty = true;
+  if (level > bits) {
+    child_empty = pop_tail(branch->child[sub], level - bits);
+  } else {
+    release(branch->child[sub]);
+    branch->child[sub] = nullptr;
+  }
+  if (child_empty && sub == 0) {
+    release(slot);
+    slot = nullptr;
+    return true;
+  }
+  return false;
+}
+
+// push_in_place
+template <typename T>
+void ForkPersistentVector<T>::push_in_place(const T &value) {
+  if (tail == nullptr) {
+    tail = new Leaf;
+    stats::allocate(sizeof(Leaf));
+  } else if (size - tail_offset() == width) {
+    Node *full = tail;
+    tail       = new Leaf;
+    stats::allocate(sizeof(Leaf));
+    if (root == nullptr) {
+      auto *branch     = new Branch;
+      branch->child[0] = full;
+      root             = branch;
+      stats::allocate(sizeof(Branch));
+    } else if ((size >> bits) > (1 << shift)) {
+      auto *branch     = new Branch;  // the tree is full, grow a level
+      branch->child[0] = root;
+      branch->child[1] = new_path(shift, full);
+      root             = branch;
+      shift += bits;
+      stats::allocate(sizeof(Branch));
+    } else {
+      push_tail(root, shift, full);
+    }
+  } else {
+    own(tail);
+  }
+  tail->values[size & index_mask] = value;
+  ++size;
+}
+// set_in_place
+template <typename T>
+void ForkPersistentVector<T>::set_in_place(const int &index, const T &value) {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  if (index >= tail_offset()) {
+    own(tail);
+    tail->values[index & index_mask] = value;
+    return;
+  }
+  Node **slot = &root;
+  for (int level = shift; level > 0; level -= bits) {
+    own(*slot);
+    slot = &static_cast<Branch *>(*slot)->child[(index >> level) & index_mask];
+  }
+  own(*slot);
+  static_cast<Leaf *>(*slot)->values[index & index_mask] = value;
+}
+// pop_in_place
+template <typename T>
+void ForkPersistentVector<T>::pop_in_place() {
+  if (size == 0) {
+    return;
+  }
+  if (size == 1) {
+    release(tail);
+    tail = nullptr;
+  } else if (size - tail_offset() > 1) {
+    own(tail);
+    tail->values[(size - 1) & index_mask] = T();  // drop what it holds
+  } else {
+    Leaf *last = leaf_for(size - 2);
+    retain(last);
+    release(tail);
+    tail = last;
+    pop_tail(root, shift);
+    if (root != nullptr && shift > bits &&
+        static_cast<Branch *>(root)->child[1] == nullptr) {
+      Node *only = static_cast<Branch *>(root)->child[0];
+      retain(only);
+      release(root);
+      root = only;
+      shift -= bits;
+    }
+    if (root == nullptr) {
+      shift = bits;
+    }
+  }
+  --size;
+}
+
+// constructor (from a ForkVector)
+template <typename T>
+ForkPersistentVector<T>::ForkPersistentVector(const ForkVector<T> &vec) {
+  T *data = vec.GetPtr();
+  for (int i = 0; i < vec.GetSize(); i++) {
+    push_in_place(data[i]);
+  }
+}
+// destructor
+template <typename T>
+ForkPersistentVector<T>::~ForkPersistentVector() {
+  release(root);
+  release(tail);
+}
+// copy constructor
+template <typename T>
+ForkPersistentVector<T>::ForkPersistentVector(const ForkPersistentVector &other)
+    : root(other.root),
+      tail(other.tail),
+      size(other.size),
+      shift(other.shift) {
+  retain(root);
+  retain(tail);
+}
+// move constructor
+template <typename T>
+ForkPersistentVector<T>::ForkPersistentVector(
+    ForkPersistentVector &&other) noexcept
+    : root(other.root),
+      tail(other.tail),
+      size(other.size),
+      shift(other.shift) {
+  other.root  = nullptr;
+  other.tail  = nullptr;
+  other.size  = 0;
+  other.shift = bits;
+}
+
+// push_back
+template <typename T>
+ForkPersistentVector<T> ForkPersistentVector<T>::push_back(
+    const T &value) const {
+  ForkPersistentVector next(*this);
+  next.push_in_place(value);
+  return next;
+}
+// pop_back
+template <typename T>
+ForkPersistentVector<T> ForkPersistentVector<T>::pop_back() const {
+  ForkPersistentVector next(*this);
+  next.pop_in_place();
+  return next;
+}
+// set_element
+template <typename T>
+ForkPersistentVector<T> ForkPersistentVector<T>::SetElement(
+    const int &index, const T &value) const {
+  ForkPersistentVector next(*this);
+  next.set_in_place(index, value);
+  return next;
+}
+// transient
+template <typename T>
+ForkTransientVector<T> ForkPersistentVector<T>::transient() const {
+  return ForkTransientVector<T>(*this);
+}
+// get_element
+template <typename T>
+const T &ForkPersistentVector<T>::GetElement(const int &index) const {
+  return (*this)[index];
+}
+// get_size
+template <typename T>
+int ForkPersistentVector<T>::GetSize() const {
+  return size;
+}
+// is_empty
+template <typename T>
+bool ForkPersistentVector<T>::is_empty() const {
+  return size == 0;
+}
+
+// operator []
+template <typename T>
+const T &ForkPersistentVector<T>::operator[](const int &index) const {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return leaf_for(index)->values[index & index_mask];
+}
+// copy assignment
+template <typename T>
+ForkPersistentVector<T> &ForkPersistentVector<T>::operator=(
+    const ForkPersistentVector &other) {
+  if (this == &other) {
+    return *this;
+  }
+  retain(other.root);
+  retain(other.tail);
+  release(root);
+  release(tail);
+  root  = other.root;
+  tail  = other.tail;
+  size  = other.size;
+  shift = other.shift;
+  return *this;
+}
+// move assignment
+template <typename T>
+ForkPersistentVector<T> &ForkPersistentVector<T>::operator=(
+    ForkPersistentVector &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  release(root);
+  release(tail);
+  root        = other.root;
+  tail        = other.tail;
+  size        = other.size;
+  shift       = other.shift;
+  other.root  = nullptr;
+  other.tail  = nullptr;
+  other.size  = 0;
+  other.shift = bits;
+  return *this;
+}
+
+// echo
+template <typename T>
+void ForkPersistentVector<T>::echo() const {
+  std::cout << "current persistent vector: ";
+  for (int i = 0; i < size; i += width) {
+    const Leaf *leaf = leaf_for(i);
+    for (int j = 0; j < width && i + j < size; j++) {
+      std::cout << leaf->values[j] << ", ";
+    }
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+
+// ForkTransientVector
+
+// constructor
+template <typename T>
+ForkTransientVector<T>::ForkTransientVector(const ForkPersistentVector<T> &base)
+    : vec(base) {}
+// push_back
+template <typename T>
+void ForkTransientVector<T>::push_back(const T &value) {
+  vec.push_in_place(value);
+}
+// pop_back
+template <typename T>
+void ForkTransientVector<T>::pop_back() {
+  vec.pop_in_place();
+}
+// set_element
+template <typename T>
+void ForkTransientVector<T>::SetElement(const int &index, const T &value) {
+  vec.set_in_place(index, value);
+}
+// get_element
+template <typename T>
+const T &ForkTransientVector<T>::GetElement(const int &index) const {
+  return vec[index];
+}
+// get_size
+template <typename T>
+int ForkTransientVector<T>::GetSize() const {
+  return vec.GetSize();
+}
+// persistent
+template <typename T>
+ForkPersistentVector<T> ForkTransientVector<T>::persistent() const {
+  return vec;
+}
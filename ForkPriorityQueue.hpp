@@ -0,0 +1,292 @@
+// d-ary heap stored in a ForkVector (default d = 4)
+// like std::priority_queue, top() is the element that compares greatest
+// a wider node means a shallower tree, and the d children of a node sit
+// next to each other in memory, so one sift-down step touches one cache line
+
+/*
+ *  parent(i) = (i - 1) / D
+ *  children(i) = D * i + 1 ... D * i + D
+ */
+
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkVector.hpp"
+
+template <typename T, typename Compare = std::less<T>, int D = 4>
+class ForkPriorityQueue {
+  static_assert(D >= 2, "ForkPriorityQueue needs at least 2 children a node");
+
+public:
+  using handle = int;  // stays valid until its element is popped
+
+private:
+  ForkVector<T> heap;           // values, in heap order
+  ForkVector<int> heap_handle;  // handle of the value at each heap slot
+  ForkVector<int> position;     // heap slot of each handle (-1 = popped)
+  ForkVector<int> free_handle;  // popped handles, reused by push()
+  Compare compare;
+
+  handle new_handle(const int &slot);
+  void sift_up(int slot);
+  void sift_down(int slot);
+  void check_handle(const handle &h) const;
+
+public:
+  // constructor and destructor
+  explicit ForkPriorityQueue(const Compare &compare = Compare());
+  template <typename InputIt>
+  ForkPriorityQueue(InputIt first, InputIt last,
+                    const Compare &compare = Compare());
+  ~ForkPriorityQueue()                                             = default;
+  ForkPriorityQueue(const ForkPriorityQueue &other)                = default;
+  ForkPriorityQueue(ForkPriorityQueue &&other) noexcept            = default;
+  ForkPriorityQueue &operator=(const ForkPriorityQueue &other)     = default;
+  ForkPriorityQueue &operator=(ForkPriorityQueue &&other) noexcept = default;
+
+  // functions
+  handle push(const T &value);  // insert, return a handle to it
+  void pop();                   // remove top()
+  [[nodiscard]] const T &top() const;
+  template <typename InputIt>
+  void heapify(InputIt first, InputIt last);  // replace contents, O(n)
+  void preAlloc(const int &n);                // reserve room for n values
+  void decrease_key(const handle &h, const T &value);  // move towards top
+  void update(const handle &h, const T &value);        // either direction
+  [[nodiscard]] const T &get_value(const handle &h) const;
+  [[nodiscard]] bool contains(const handle &h) const;
+  void erase();  // remove everything
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] bool is_empty() const;
+
+  // echo
+  void echo() const;  // print in heap order
+};
+
+// constructor
+template <typename T, typename Compare, int D>
+ForkPriorityQueue<T, Compare, D>::ForkPriorityQueue(const Compare &compare)
+    : compare(compare) {}
+// constructor (heapify a range)
+template <typename T, typename Compare, int D>
+template <typename InputIt>
+ForkPriorityQueue<T, Compare, D>::ForkPriorityQueue(InputIt first,
+                                                    InputIt last,
+                                                    const Compare &compare)
+    : compare(compare) {
+  heapify(first, last);
+}
+
+// new_handle
+template <typename T, typename Compare, int D>
+int ForkPriorityQueue<T, Compare, D>::new_handle(const int &slot) {
+  if (free_handle.GetSize() > 0) {
+    int h = free_handle.GetPtr()[free_handle.GetSize() - 1];
+    free_handle.pop_back();
+    position.GetPtr()[h] = slot;
+    return h;
+  }
+  position.push_back(slot);
+  return position.GetSize() - 1;
+}
+// sift_up (hole technique: shift parents down, write the value once)
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::sift_up(int slot) {
+  T *values   = heap.GetPtr();
+  int *owners = heap_handle.GetPtr();
+  int *where  = position.GetPtr();
+  T value     = std::move(values[slot]);
+  int owner   = owners[slot];
+  while (slot > 0) {
+    int parent = (slot - 1) / D;
+    if (!compare(values[parent], value)) {
+      break;
+    }
+    values[slot]        = std::move(values[parent]);
+    owners[slot]        = owners[parent];
+    where[owners[slot]] = slot;
+    slot                = parent;
+  }
+  values[slot] = std::move(value);
+  owners[slot] = owner;
+  where[owner] = slot;
+}
+// sift_down
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::sift_down(int slot) {
+  T *values   = heap.GetPtr();
+  int *owners = heap_handle.GetPtr();
+  int *where  = position.GetPtr();
+  int n       = heap.GetSize();
+  T value     = std::move(values[slot]);
+  int owner   = owners[slot];
+  while (true) {
+    int first = D * slot + 1;
+    if (first >= n) {
+      break;
+    }
+    int last = first + D < n ? first + D : n;
+    int best = first;
+    for (int child = first + 1; child < last; child++) {
+      if (compare(values[best], values[child])) {
+        best = child;
+      }
+    }
+    if (!compare(value, values[best])) {
+      break;
+    }
+    values[slot]        = std::move(values[best]);
+    owners[slot]        = owners[best];
+    where[owners[slot]] = slot;
+    slot                = best;
+  }
+  values[slot] = std::move(value);
+  owners[slot] = owner;
+  where[owner] = slot;
+}
+// check_handle
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::check_handle(const handle &h) const {
+  if (!contains(h)) {
+    throw std::out_of_range("invalid priority queue handle");
+  }
+}
+
+// push
+template <typename T, typename Compare, int D>
+int ForkPriorityQueue<T, Compare, D>::push(const T &value) {
+  int slot = heap.GetSize();
+  heap.push_back(value);
+  handle h = new_handle(slot);
+  heap_handle.push_back(h);
+  sift_up(slot);
+  return h;
+}
+// pop
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::pop() {
+  int n = heap.GetSize();
+  if (n == 0) {
+    throw std::out_of_range("priority queue is empty");
+  }
+  T *values   = heap.GetPtr();
+  int *owners = heap_handle.GetPtr();
+  int gone    = owners[0];
+
+  position.GetPtr()[gone] = -1;
+  free_handle.push_back(gone);
+  if (n > 1) {
+    values[0] = std::move(values[n - 1]);
+    owners[0] = owners[n - 1];
+  }
+  heap.pop_back();
+  heap_handle.pop_back();
+  if (n > 1) {
+    sift_down(0);
+  }
+}
+// top
+template <typename T, typename Compare, int D>
+const T &ForkPriorityQueue<T, Compare, D>::top() const {
+  if (heap.GetSize() == 0) {
+    throw std::out_of_range("priority queue is empty");
+  }
+  return heap.GetPtr()[0];
+}
+// heapify (Floyd: sift down every internal node, bottom-up)
+// handles are handed out in input order: the i-th value gets handle i
+template <typename T, typename Compare, int D>
+template <typename InputIt>
+void ForkPriorityQueue<T, Compare, D>::heapify(InputIt first, InputIt last) {
+  erase();
+  for (; first != last; ++first) {
+    heap.push_back(*first);
+  }
+  int n = heap.GetSize();
+  heap_handle.preAlloc(n);
+  position.preAlloc(n);
+  for (int i = 0; i < n; i++) {
+    heap_handle.push_back(i);
+    position.push_back(i);
+  }
+  for (int slot = (n - 2) / D; slot >= 0 && n > 1; slot--) {
+    sift_down(slot);
+  }
+}
+// preAlloc
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::preAlloc(const int &n) {
+  heap.preAlloc(n);
+  heap_handle.preAlloc(n);
+  position.preAlloc(n);
+}
+// decrease_key (the new value must not have a lower priority)
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::decrease_key(const handle &h,
+                                                    const T &value) {
+  check_handle(h);
+  int slot = position.GetPtr()[h];
+  if (compare(value, heap.GetPtr()[slot])) {
+    throw std::invalid_argument("decrease_key would lower the priority");
+  }
+  heap.GetPtr()[slot] = value;
+  sift_up(slot);
+}
+// update
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::update(const handle &h,
+                                              const T &value) {
+  check_handle(h);
+  int slot           = position.GetPtr()[h];
+  bool goes_up       = compare(heap.GetPtr()[slot], value);
+  heap.GetPtr()[slot] = value;
+  if (goes_up) {
+    sift_up(slot);
+  } else {
+    sift_down(slot);
+  }
+}
+// get_value
+template <typename T, typename Compare, int D>
+const T &ForkPriorityQueue<T, Compare, D>::get_value(const handle &h) const {
+  check_handle(h);
+  return heap.GetPtr()[position.GetPtr()[h]];
+}
+// contains
+template <typename T, typename Compare, int D>
+bool ForkPriorityQueue<T, Compare, D>::contains(const handle &h) const {
+  return h >= 0 && h < position.GetSize() && position.GetPtr()[h] >= 0;
+}
+// erase
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::erase() {
+  heap.clear();
+  heap_handle.clear();
+  position.clear();
+  free_handle.clear();
+}
+// get_size
+template <typename T, typename Compare, int D>
+int ForkPriorityQueue<T, Compare, D>::get_size() const {
+  return heap.GetSize();
+}
+// is_empty
+template <typename T, typename Compare, int D>
+bool ForkPriorityQueue<T, Compare, D>::is_empty() const {
+  return heap.GetSize() == 0;
+}
+
+// echo
+template <typename T, typename Compare, int D>
+void ForkPriorityQueue<T, Compare, D>::echo() const {
+  std::cout << "current heap: ";
+  for (int i = 0; i < heap.GetSize(); i++) {
+    std::cout << heap.GetPtr()[i] << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
@@ -1,25 +1,30 @@
 ﻿// those who joined the queue earlier will be fetched first
 // those who joined the queue later will be fetched later
 
-// #pragma once
+#pragma once
 
 #include <iostream>
 #include <iterator>
+
+#include "ForkChain.hpp"
+#include "ForkExport.hpp"
+#include "ForkStats.hpp"
+#include "ForkValueIndex.hpp"
 using namespace std;
 
 template <typename T>
 class ForkQueue {
+public:
+  using value_type = T;
+
 private:
-  class Node {
-  public:
-    T data;
-    Node *front = nullptr;
-    Node *back  = nullptr;
-    explicit Node(const T &data) { this->data = data; }
-  };
-  Node *head = nullptr;
-  Node *tail = nullptr;
-  int size   = 0;
+  using stats = ForkStatsOf<ForkQueue>;  // no-op unless FORK_STL_STATS
+  using Node  = ForkChainNode<T>;        // next: toward the tail
+
+  Node *head                     = nullptr;
+  Node *tail                     = nullptr;
+  int size                       = 0;
+  ForkValueIndex<T> *value_index = nullptr;  // from the head
 
 public:
   // constructor and destructor
@@ -27,13 +32,16 @@ public:
   ~ForkQueue();
   ForkQueue(const ForkQueue &other);
   ForkQueue(ForkQueue &&other) noexcept;
+  explicit ForkQueue(ForkChain<T> &&chain);  // adopts the nodes, head first
+  template <ForkChainSource<T> Source>
+  explicit ForkQueue(Source &&from);  // steals a ForkList / ForkStack, O(1)
 
   // functions
   void push(const T &data);  // push a node into the queue
   void quit_head();          // quit head node from the queue
   void quit_tail();          // quit tail node from the queue
-  T &fetch_head();           // fetch head node from the queue
-  T &fetch_tail();           // fetch tail node from the queue
+  T fetch_head();            // fetch head node from the queue
+  T fetch_tail();            // fetch tail node from the queue
   void erase();
   void clear();
   T &get_element(const int &index);                   // index counted from head
@@ -44,6 +52,16 @@ public:
   [[nodiscard]] int get_index(const T &value) const;  // get_index
   [[nodiscard]] int get_size() const;                 // get_size
 
+  // opt-in value index, get_index becomes a hash probe (ForkValueIndex.hpp)
+  void enable_index(const int &bloom_bits = 0);  // bloom_bits 0: no filter
+  void disable_index();
+  void rebuild_index();  // after writes through get_element / iterators
+  [[nodiscard]] bool is_indexed() const;
+
+  // node handoff without copies (ForkChain.hpp), O(1) unless indexed
+  ForkChain<T> release_chain();            // give every node away
+  void splice_back(ForkChain<T> &&chain);  // append a batch at the tail
+
   // iterator
   class iterator {
   private:
@@ -54,11 +72,11 @@ public:
     explicit iterator(Node *node) : node(node) {}
     T &operator*() { return node->data; }
     iterator &operator++() {
-      node = node->front;
+      node = node->next;
       return *this;
     }
     iterator &operator--() {
-      node = node->back;
+      node = node->prev;
       return *this;
     }
     bool operator==(const iterator &other) const { return node == other.node; }
@@ -81,8 +99,9 @@ public:
   bool operator==(const ForkQueue &other) const;
   bool operator!=(const ForkQueue &other) const;
 
-  // echo
+  // echo and export (head to tail)
   void echo() const;
+  void export_to(ForkExport &out) const;
 };
 
 // constructor and destructor
@@ -90,61 +109,75 @@ template <typename T>
 ForkQueue<T>::ForkQueue(const ForkQueue &other) {
   Node *curr = other.head;
   while (curr != nullptr) {
-    Node *temp = new Node(curr->data);
-    if (head == nullptr) {
-      head = temp;
-    } else {
-      tail->front = temp;
-    }
-    tail = temp;
-    curr = curr->front;
+    push(curr->data);
+    curr = curr->next;
+  }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
   }
-  size = other.size;
 }
 template <typename T>
 ForkQueue<T>::~ForkQueue() {
   Node *curr = head;
   while (curr != nullptr) {
     Node *temp = curr;
-    curr       = curr->front;
+    curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
+  delete value_index;
 }
 template <typename T>
 ForkQueue<T>::ForkQueue(ForkQueue &&other) noexcept {
-  head       = other.head;
-  tail       = other.tail;
-  size       = other.size;
-  other.head = nullptr;
-  other.tail = nullptr;
-  other.size = 0;
+  head              = other.head;
+  tail              = other.tail;
+  size              = other.size;
+  value_index       = other.value_index;
+  other.head        = nullptr;
+  other.tail        = nullptr;
+  other.size        = 0;
+  other.value_index = nullptr;
 }
 
 // functions
 template <typename T>
 void ForkQueue<T>::push(const T &data) {
   Node *curr = new Node(data);
+  stats::allocate(sizeof(Node));
+  stats::elements(1);
   if (!head) {
     head = curr;
     tail = curr;
   } else {
-    tail->back  = curr;
-    curr->front = tail;
-    tail        = curr;
+    tail->next = curr;
+    curr->prev = tail;
+    tail       = curr;
+  }
+  if (value_index != nullptr) {
+    value_index->push_back(curr->data);
   }
   ++size;
+  stats::shape(size, size);
 }
 template <typename T>
 void ForkQueue<T>::quit_head() {
   if (head == nullptr) {
     return;
   }
+  if (value_index != nullptr) {
+    value_index->pop_front(head->data);
+  }
   Node *temp = head;
-  head       = head->back;
+  head       = head->next;
   if (head) {
-    head->front = nullptr;
+    head->prev = nullptr;
+  } else {
+    tail = nullptr;
   }
   delete temp;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
   --size;
 }
 template <typename T>
@@ -152,22 +185,35 @@ void ForkQueue<T>::quit_tail() {
   if (tail == nullptr) {
     return;
   }
+  if (value_index != nullptr) {
+    value_index->pop_back(tail->data);
+  }
   Node *temp = tail;
-  tail       = tail->front;
-  if (tail == nullptr) {
-    tail->back = nullptr;
+  tail       = tail->prev;
+  if (tail) {
+    tail->next = nullptr;
+  } else {
+    head = nullptr;
   }
   delete temp;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
   --size;
 }
 template <typename T>
-T &ForkQueue<T>::fetch_head() {
+T ForkQueue<T>::fetch_head() {
+  if (head == nullptr) {
+    throw std::out_of_range("queue is empty");
+  }
   T data = head->data;
   quit_head();
   return data;
 }
 template <typename T>
-T &ForkQueue<T>::fetch_tail() {
+T ForkQueue<T>::fetch_tail() {
+  if (tail == nullptr) {
+    throw std::out_of_range("queue is empty");
+  }
   T data = tail->data;
   quit_tail();
   return data;
@@ -177,24 +223,34 @@ void ForkQueue<T>::erase() {
   Node *curr = head;
   while (curr != nullptr) {
     Node *temp = curr;
-    curr       = curr->front;
+    curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
   head = nullptr;
   tail = nullptr;
   size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
 }
 template <typename T>
 void ForkQueue<T>::clear() {
   Node *curr = head;
   while (curr != nullptr) {
     Node *temp = curr;
-    curr       = curr->front;
+    curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
   head = nullptr;
   tail = nullptr;
   size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
 }
 template <typename T>
 T &ForkQueue<T>::get_element(const int &index) {
@@ -203,8 +259,9 @@ T &ForkQueue<T>::get_element(const int &index) {
   }
   Node *curr = head;
   for (int i = 0; i < index; ++i) {
-    curr = curr->front;
+    curr = curr->next;
   }
+  stats::walk(index);
   return curr->data;
 }
 template <typename T>
@@ -214,7 +271,11 @@ void ForkQueue<T>::set_element(const int &index, const T &data) {
   }
   Node *curr = head;
   for (int i = 0; i < index; ++i) {
-    curr = curr->front;
+    curr = curr->next;
+  }
+  stats::walk(index);
+  if (value_index != nullptr) {
+    value_index->replace(index, curr->data, data);
   }
   curr->data = data;
 }
@@ -233,27 +294,109 @@ auto ForkQueue<T>::data_at(const int &index) -> decltype(head) {
   }
   Node *curr = head;
   for (int i = 0; i < index; ++i) {
-    curr = curr->front;
+    curr = curr->next;
   }
+  stats::walk(index);
   return curr;
 }
 template <typename T>
 int ForkQueue<T>::get_index(const T &value) const {
+  if (value_index != nullptr) {
+    return value_index->first(value);
+  }
   Node *curr = head;
   int index  = 0;
   while (curr != nullptr) {
     if (curr->data == value) {
+      stats::walk(index + 1);
       return index;
     }
-    curr = curr->front;
+    curr = curr->next;
     ++index;
   }
+  stats::walk(index);
   return -1;
 }
 template <typename T>
 int ForkQueue<T>::get_size() const {
   return size;
 }
+template <typename T>
+void ForkQueue<T>::enable_index(const int &bloom_bits) {
+  delete value_index;
+  value_index = new ForkValueIndex<T>(bloom_bits);
+  rebuild_index();
+}
+template <typename T>
+void ForkQueue<T>::disable_index() {
+  delete value_index;
+  value_index = nullptr;
+}
+template <typename T>
+void ForkQueue<T>::rebuild_index() {
+  if (value_index == nullptr) {
+    return;
+  }
+  value_index->clear();
+  for (Node *curr = head; curr != nullptr; curr = curr->next) {
+    value_index->push_back(curr->data);
+  }
+}
+template <typename T>
+bool ForkQueue<T>::is_indexed() const {
+  return value_index != nullptr;
+}
+
+// chain handoff (ForkChain.hpp)
+template <typename T>
+ForkQueue<T>::ForkQueue(ForkChain<T> &&chain) {
+  head = chain.data_head();
+  tail = chain.data_tail();
+  size = chain.get_size();
+  chain.release();
+  stats::adopt(size * static_cast<long long>(sizeof(Node)), size);
+  stats::shape(size, size);
+}
+template <typename T>
+template <ForkChainSource<T> Source>
+ForkQueue<T>::ForkQueue(Source &&from) : ForkQueue(from.release_chain()) {}
+template <typename T>
+ForkChain<T> ForkQueue<T>::release_chain() {
+  ForkChain<T> chain(head, tail, size);
+  stats::adopt(-size * static_cast<long long>(sizeof(Node)), -size);
+  head = nullptr;
+  tail = nullptr;
+  size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
+  return chain;
+}
+template <typename T>
+void ForkQueue<T>::splice_back(ForkChain<T> &&chain) {
+  if (chain.is_empty()) {
+    return;
+  }
+  Node *first = chain.data_head();
+  Node *last  = chain.data_tail();
+  int count   = chain.get_size();
+  chain.release();
+  stats::adopt(count * static_cast<long long>(sizeof(Node)), count);
+  if (tail == nullptr) {
+    head = first;
+  } else {
+    tail->next  = first;
+    first->prev = tail;
+  }
+  tail = last;
+  if (value_index != nullptr) {
+    for (Node *curr = first; curr != nullptr; curr = curr->next) {
+      value_index->push_back(curr->data);
+    }
+  }
+  size += count;
+  stats::shape(size, size);
+}
 
 // iterator
 template <typename T>
@@ -291,19 +434,36 @@ bool ForkQueue<T>::operator!=(const ForkQueue::iterator &other) const {
 }
 template <typename T>
 auto ForkQueue<T>::operator=(const ForkQueue &other) -> ForkQueue<T> & {
-  head = other.head;
-  tail = other.tail;
-  size = other.size;
+  if (this == &other) {
+    return *this;
+  }
+  disable_index();  // the index follows the contents
+  erase();
+  Node *curr = other.head;
+  while (curr != nullptr) {
+    push(curr->data);
+    curr = curr->next;
+  }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
+  }
   return *this;
 }
 template <typename T>
 auto ForkQueue<T>::operator=(ForkQueue &&other) noexcept -> ForkQueue<T> & {
-  head       = other.head;
-  tail       = other.tail;
-  size       = other.size;
-  other.head = nullptr;
-  other.tail = nullptr;
-  other.size = 0;
+  if (this == &other) {
+    return *this;
+  }
+  erase();
+  delete value_index;
+  head              = other.head;
+  tail              = other.tail;
+  size              = other.size;
+  value_index       = other.value_index;
+  other.head        = nullptr;
+  other.tail        = nullptr;
+  other.size        = 0;
+  other.value_index = nullptr;
   return *this;
 }
 template <typename T>
@@ -319,8 +479,16 @@ void ForkQueue<T>::echo() const {
   Node *curr = head;
   while (curr != nullptr) {
     std::cout << curr->data << ", ";
-    curr = curr->back;
+    curr = curr->next;
   }
   std::cout << "\b\b  \b\b" << std::endl;
   std::cout << std::endl;
+}
+// export_to
+template <typename T>
+void ForkQueue<T>::export_to(ForkExport &out) const {
+  for (Node *curr = head; curr != nullptr; curr = curr->next) {
+    out.add(curr->data);
+  }
+  out.end_record();
 }
\ No newline at end of file
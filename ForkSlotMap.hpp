@@ -0,0 +1,215 @@
+// slot map: stable, generation-checked handles into dense storage
+// values live contiguously in a ForkVector (iteration never skips holes),
+// a handle names a slot, and the slot knows where its value currently is;
+// erase moves the last value into the hole, so nothing else shifts
+//
+// a slot's generation is odd while it is occupied and is bumped again on
+// erase, so a handle to an erased value is rejected even after its slot
+// was reused. free slots form a list threaded through the slot table
+
+/*
+ *  slots:  [ pos 1, gen 3 | free, gen 2 | pos 0, gen 1 ]
+ *  values: [ c | a ]          owners: [ 2 | 0 ]
+ */
+
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkVector.hpp"
+
+template <typename T>
+class ForkSlotMap {
+public:
+  using value_type = T;
+
+  class Handle {
+  public:
+    int index               = -1;  // slot
+    unsigned int generation = 0;   // odd, matches the slot while it lives
+    bool operator==(const Handle &other) const {
+      return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const Handle &other) const { return !(*this == other); }
+  };
+
+private:
+  class Slot {
+  public:
+    int position            = -1;  // in values, or the next free slot
+    unsigned int generation = 0;   // even while free
+  };
+
+  ForkVector<Slot> slots;
+  ForkVector<T> values;    // dense
+  ForkVector<int> owners;  // owners[i] is the slot of values[i]
+  int free_head = -1;
+
+  [[nodiscard]] int position_of(const Handle &handle) const;  // -1 if stale
+
+public:
+  // constructor and destructor
+  ForkSlotMap() = default;
+
+  // functions
+  Handle insert(const T &value);
+  bool erase(const Handle &handle);  // false if the handle is stale
+  void clear();                      // every handle becomes stale
+  void preAlloc(const int &n);
+  [[nodiscard]] bool contains(const Handle &handle) const;
+  T *get(const Handle &handle);  // nullptr if the handle is stale
+  const T *get(const Handle &handle) const;
+  T &GetElement(const Handle &handle);                        // throws if stale
+  [[nodiscard]] Handle GetHandle(const int &position) const;  // of values[i]
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] bool is_empty() const;
+  T *begin() { return values.GetPtr(); }
+  T *end() { return values.GetPtr() + values.GetSize(); }
+  const T *begin() const { return values.GetPtr(); }
+  const T *end() const { return values.GetPtr() + values.GetSize(); }
+
+  // operator overloading
+  T &operator[](const Handle &handle);  // throws if stale
+
+  // echo
+  void echo() const;
+};
+
+// position_of
+template <typename T>
+int ForkSlotMap<T>::position_of(const Handle &handle) const {
+  if (handle.index < 0 || handle.index >= slots.GetSize()) {
+    return -1;
+  }
+  const Slot &slot = slots.GetPtr()[handle.index];
+  if (slot.generation != handle.generation || (slot.generation & 1u) == 0) {
+    return -1;
+  }
+  return slot.position;
+}
+
+// insert
+template <typename T>
+typename ForkSlotMap<T>::Handle ForkSlotMap<T>::insert(const T &value) {
+  int index = free_head;
+  if (index < 0) {
+    index = slots.GetSize();
+    slots.push_back(Slot());
+  } else {
+    free_head = slots.GetPtr()[index].position;
+  }
+  Slot &slot = slots.GetPtr()[index];
+  ++slot.generation;  // now odd: occupied
+  slot.position = values.GetSize();
+  values.push_back(value);
+  owners.push_back(index);
+  return Handle{index, slot.generation};
+}
+// erase (the last value fills the hole)
+template <typename T>
+bool ForkSlotMap<T>::erase(const Handle &handle) {
+  int position = position_of(handle);
+  if (position < 0) {
+    return false;
+  }
+  T *dense   = values.GetPtr();
+  int *owner = owners.GetPtr();
+  int last   = values.GetSize() - 1;
+  if (position != last) {
+    dense[position]                          = std::move(dense[last]);
+    owner[position]                          = owner[last];
+    slots.GetPtr()[owner[position]].position = position;
+  }
+  dense[last] = T();  // release what the moved-from value holds
+  values.pop_back();
+  owners.pop_back();
+  Slot &slot = slots.GetPtr()[handle.index];
+  ++slot.generation;  // now even: free
+  slot.position = free_head;
+  free_head     = handle.index;
+  return true;
+}
+// clear all
+template <typename T>
+void ForkSlotMap<T>::clear() {
+  for (int i = 0; i < owners.GetSize(); i++) {
+    Slot &slot = slots.GetPtr()[owners[i]];
+    ++slot.generation;
+    slot.position = free_head;
+    free_head     = owners[i];
+  }
+  values.ResetAll(T());
+  values.clear();
+  owners.clear();
+}
+// pre_alloc
+template <typename T>
+void ForkSlotMap<T>::preAlloc(const int &n) {
+  slots.preAlloc(n);
+  values.preAlloc(n);
+  owners.preAlloc(n);
+}
+// contains
+template <typename T>
+bool ForkSlotMap<T>::contains(const Handle &handle) const {
+  return position_of(handle) >= 0;
+}
+// get
+template <typename T>
+T *ForkSlotMap<T>::get(const Handle &handle) {
+  int position = position_of(handle);
+  return position >= 0 ? values.GetPtr() + position : nullptr;
+}
+template <typename T>
+const T *ForkSlotMap<T>::get(const Handle &handle) const {
+  int position = position_of(handle);
+  return position >= 0 ? values.GetPtr() + position : nullptr;
+}
+// get_element
+template <typename T>
+T &ForkSlotMap<T>::GetElement(const Handle &handle) {
+  return (*this)[handle];
+}
+// get_handle
+template <typename T>
+typename ForkSlotMap<T>::Handle ForkSlotMap<T>::GetHandle(
+    const int &position) const {
+  if (position < 0 || position >= values.GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  int index = owners.GetPtr()[position];
+  return Handle{index, slots.GetPtr()[index].generation};
+}
+// get_size
+template <typename T>
+int ForkSlotMap<T>::GetSize() const {
+  return values.GetSize();
+}
+// is_empty
+template <typename T>
+bool ForkSlotMap<T>::is_empty() const {
+  return values.GetSize() == 0;
+}
+
+// operator []
+template <typename T>
+T &ForkSlotMap<T>::operator[](const Handle &handle) {
+  int position = position_of(handle);
+  if (position < 0) {
+    throw std::out_of_range("stale handle");
+  }
+  return values.GetPtr()[position];
+}
+
+// echo
+template <typename T>
+void ForkSlotMap<T>::echo() const {
+  std::cout << "current slot map: ";
+  for (const T &value : *this) {
+    std::cout << value << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
@@ -0,0 +1,361 @@
+// structure-of-arrays vector for multi-field records
+// ForkSoAVector<int, float, char> keeps one contiguous column per field,
+// each starting on a cache line, so a loop over one field streams only that
+// field and the compiler can vectorize it through column<I>()
+//
+// push_back / GetSize / preAlloc / capacity doubling follow ForkVector;
+// rows() zips the columns back together: for (auto [id, x] : v.rows())
+
+/*
+ *  column<0>: [ id0 | id1 | id2 | ... ]
+ *  column<1>: [ x0  | x1  | x2  | ... ]
+ *  column<2>: [ c0  | c1  | c2  | ... ]
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ForkStats.hpp"
+
+template <typename... Fields>
+class ForkSoAVector {
+public:
+  using value_type      = std::tuple<Fields...>;
+  using reference       = std::tuple<Fields &...>;
+  using const_reference = std::tuple<const Fields &...>;
+  template <std::size_t I>
+  using field_type = std::tuple_element_t<I, value_type>;
+  static constexpr std::size_t alignment = 64;  // every column on a new line
+
+private:
+  using stats   = ForkStatsOf<ForkSoAVector>;  // no-op unless FORK_STL_STATS
+  using indices = std::index_sequence_for<Fields...>;
+  static constexpr long long row_bytes = (0 + ... + sizeof(Fields));
+
+  std::tuple<Fields *...> columns{};  // raw storage, [0, size) constructed
+  int size     = 0;
+  int capacity = 0;
+
+  template <typename T>
+  static T *allocate_column(const int &n);
+  template <typename T>
+  static void release_column(T *column);
+  template <std::size_t... I>
+  void reallocate(const int &n, std::index_sequence<I...>);
+  template <std::size_t... I>
+  void destroy(const int &first, std::index_sequence<I...>);  // [first, size)
+  template <std::size_t... I>
+  void construct_back(std::index_sequence<I...>, const Fields &...values);
+  template <std::size_t... I>
+  reference row(const int &index, std::index_sequence<I...>);
+  template <std::size_t... I>
+  const_reference row(const int &index, std::index_sequence<I...>) const;
+
+public:
+  // zipped view over the columns, yields a tuple of references per row,
+  // const ones (const_reference) through a const vector
+  template <bool Const>
+  class basic_iterator {
+  public:
+    using owner_type = std::conditional_t<Const, const ForkSoAVector,
+                                          ForkSoAVector>;
+    using row_type   = std::conditional_t<Const, const_reference, reference>;
+    owner_type *owner;
+    int index;
+    row_type operator*() const { return owner->row(index, indices()); }
+    basic_iterator &operator++() {
+      ++index;
+      return *this;
+    }
+    bool operator!=(const basic_iterator &other) const {
+      return index != other.index;
+    }
+  };
+  using iterator       = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  template <bool Const>
+  class basic_rows {
+  public:
+    typename basic_iterator<Const>::owner_type *owner;
+    basic_iterator<Const> begin() const { return {owner, 0}; }
+    basic_iterator<Const> end() const { return {owner, owner->size}; }
+  };
+  using Rows      = basic_rows<false>;
+  using ConstRows = basic_rows<true>;
+
+  // constructor and destructor
+  ForkSoAVector() = default;
+  ~ForkSoAVector();
+  ForkSoAVector(const ForkSoAVector &other);
+  ForkSoAVector(ForkSoAVector &&other) noexcept;
+
+  // functions
+  void preAlloc(const int &n);  // pre_allocate_capacity
+  void push_back(const Fields &...values);
+  void pop_back();
+  void clear();  // clear [data_only]
+  void erase();  // erase [data & capacity]
+  [[nodiscard]] int GetSize() const;
+  [[nodiscard]] int GetCapacity() const;
+  [[nodiscard]] bool is_empty() const;
+  template <std::size_t I>
+  std::span<field_type<I>> column();  // contiguous, aligned to `alignment`
+  template <std::size_t I>
+  std::span<const field_type<I>> column() const;
+  reference GetElement(const int &index);
+  void SetElement(const int &index, const Fields &...values);
+  Rows rows() { return Rows{this}; }
+  ConstRows rows() const { return ConstRows{this}; }
+
+  // operator overloading
+  reference operator[](const int &index);
+  const_reference operator[](const int &index) const;
+  ForkSoAVector &operator=(const ForkSoAVector &other);
+  ForkSoAVector &operator=(ForkSoAVector &&other) noexcept;
+
+  // echo
+  void echo() const;
+};
+
+// allocate_column
+template <typename... Fields>
+template <typename T>
+T *ForkSoAVector<Fields...>::allocate_column(const int &n) {
+  return static_cast<T *>(
+      ::operator new(n * sizeof(T), std::align_val_t(alignment)));
+}
+// release_column (elements must already be destroyed)
+template <typename... Fields>
+template <typename T>
+void ForkSoAVector<Fields...>::release_column(T *column) {
+  ::operator delete(column, std::align_val_t(alignment));
+}
+// reallocate (move every column into storage for n rows)
+template <typename... Fields>
+template <std::size_t... I>
+void ForkSoAVector<Fields...>::reallocate(const int &n,
+                                          std::index_sequence<I...>) {
+  std::tuple<Fields *...> fresh(allocate_column<Fields>(n)...);
+  (std::uninitialized_move_n(std::get<I>(columns), size, std::get<I>(fresh)),
+   ...);
+  (std::destroy_n(std::get<I>(columns), size), ...);
+  (release_column(std::get<I>(columns)), ...);
+  stats::reallocate(capacity * row_bytes, n * row_bytes, size * row_bytes);
+  columns  = fresh;
+  capacity = n;
+  stats::shape(size, capacity);
+}
+// destroy
+template <typename... Fields>
+template <std::size_t... I>
+void ForkSoAVector<Fields...>::destroy(const int &first,
+                                       std::index_sequence<I...>) {
+  (std::destroy(std::get<I>(columns) + first, std::get<I>(columns) + size),
+   ...);
+  stats::elements(first - size);
+  size = first;
+}
+// construct_back
+template <typename... Fields>
+template <std::size_t... I>
+void ForkSoAVector<Fields...>::construct_back(std::index_sequence<I...>,
+                                              const Fields &...values) {
+  (new (std::get<I>(columns) + size) Fields(values), ...);
+}
+// row
+template <typename... Fields>
+template <std::size_t... I>
+typename ForkSoAVector<Fields...>::reference ForkSoAVector<Fields...>::row(
+    const int &index, std::index_sequence<I...>) {
+  return reference(std::get<I>(columns)[index]...);
+}
+template <typename... Fields>
+template <std::size_t... I>
+typename ForkSoAVector<Fields...>::const_reference
+ForkSoAVector<Fields...>::row(const int &index,
+                              std::index_sequence<I...>) const {
+  return const_reference(std::get<I>(columns)[index]...);
+}
+
+// destructor
+template <typename... Fields>
+ForkSoAVector<Fields...>::~ForkSoAVector() {
+  erase();
+}
+// copy constructor
+template <typename... Fields>
+ForkSoAVector<Fields...>::ForkSoAVector(const ForkSoAVector &other) {
+  preAlloc(other.size);
+  for (int i = 0; i < other.size; i++) {
+    std::apply([this](const Fields &...values) { push_back(values...); },
+               other[i]);
+  }
+}
+// move constructor
+template <typename... Fields>
+ForkSoAVector<Fields...>::ForkSoAVector(ForkSoAVector &&other) noexcept
+    : columns(other.columns), size(other.size), capacity(other.capacity) {
+  other.columns  = std::tuple<Fields *...>();
+  other.size     = 0;
+  other.capacity = 0;
+}
+
+// pre_allocate_capacity
+template <typename... Fields>
+void ForkSoAVector<Fields...>::preAlloc(const int &n) {
+  int input = n < size ? size : n;  // never discard data
+  if (input > capacity) {
+    reallocate(input, indices());
+  }
+}
+// push_back
+template <typename... Fields>
+void ForkSoAVector<Fields...>::push_back(const Fields &...values) {
+  if (size == capacity) {
+    preAlloc(capacity > 0 ? capacity * 2 : 1);
+  }
+  construct_back(indices(), values...);
+  ++size;
+  stats::elements(1);
+  stats::shape(size, capacity);
+}
+// pop_back
+template <typename... Fields>
+void ForkSoAVector<Fields...>::pop_back() {
+  if (size > 0) {
+    destroy(size - 1, indices());
+  }
+}
+// clear all
+template <typename... Fields>
+void ForkSoAVector<Fields...>::clear() {
+  destroy(0, indices());
+}
+// erase all
+template <typename... Fields>
+void ForkSoAVector<Fields...>::erase() {
+  clear();
+  if (capacity > 0) {
+    std::apply([](Fields *...column) { (release_column(column), ...); },
+               columns);
+    stats::release(capacity * row_bytes);
+  }
+  columns  = std::tuple<Fields *...>();
+  capacity = 0;
+}
+// get_size
+template <typename... Fields>
+int ForkSoAVector<Fields...>::GetSize() const {
+  return size;
+}
+// get_capacity
+template <typename... Fields>
+int ForkSoAVector<Fields...>::GetCapacity() const {
+  return capacity;
+}
+// is_empty
+template <typename... Fields>
+bool ForkSoAVector<Fields...>::is_empty() const {
+  return size == 0;
+}
+// column
+template <typename... Fields>
+template <std::size_t I>
+std::span<typename ForkSoAVector<Fields...>::template field_type<I>>
+ForkSoAVector<Fields...>::column() {
+  return std::span<field_type<I>>(std::get<I>(columns), size);
+}
+template <typename... Fields>
+template <std::size_t I>
+std::span<const typename ForkSoAVector<Fields...>::template field_type<I>>
+ForkSoAVector<Fields...>::column() const {
+  return std::span<const field_type<I>>(std::get<I>(columns), size);
+}
+// get_element
+template <typename... Fields>
+typename ForkSoAVector<Fields...>::reference
+ForkSoAVector<Fields...>::GetElement(const int &index) {
+  return (*this)[index];
+}
+// set_element
+template <typename... Fields>
+void ForkSoAVector<Fields...>::SetElement(const int &index,
+                                          const Fields &...values) {
+  (*this)[index] = std::tie(values...);
+}
+
+// operator []
+template <typename... Fields>
+typename ForkSoAVector<Fields...>::reference
+ForkSoAVector<Fields...>::operator[](const int &index) {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return row(index, indices());
+}
+template <typename... Fields>
+typename ForkSoAVector<Fields...>::const_reference
+ForkSoAVector<Fields...>::operator[](const int &index) const {
+  if (index < 0 || index >= size) {
+    throw std::out_of_range("index out of range");
+  }
+  return row(index, indices());
+}
+// copy assignment
+template <typename... Fields>
+ForkSoAVector<Fields...> &ForkSoAVector<Fields...>::operator=(
+    const ForkSoAVector &other) {
+  if (this == &other) {
+    return *this;
+  }
+  clear();
+  preAlloc(other.size);
+  for (int i = 0; i < other.size; i++) {
+    std::apply([this](const Fields &...values) { push_back(values...); },
+               other[i]);
+  }
+  return *this;
+}
+// move assignment
+template <typename... Fields>
+ForkSoAVector<Fields...> &ForkSoAVector<Fields...>::operator=(
+    ForkSoAVector &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  erase();
+  columns        = other.columns;
+  size           = other.size;
+  capacity       = other.capacity;
+  other.columns  = std::tuple<Fields *...>();
+  other.size     = 0;
+  other.capacity = 0;
+  return *this;
+}
+
+// echo
+template <typename... Fields>
+void ForkSoAVector<Fields...>::echo() const {
+  std::cout << "current soa vector: ";
+  for (int i = 0; i < size; i++) {
+    std::cout << "(";
+    std::apply(
+        [](const Fields &...values) {
+          int field = 0;
+          ((std::cout << (field++ == 0 ? "" : " ") << values), ...);
+        },
+        (*this)[i]);
+    std::cout << "), ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
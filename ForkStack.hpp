@@ -2,28 +2,33 @@
 // last in, first out
 
 /*
- *  [surface] <-(upper)- [node] -(lower)-> [bottom]
+ *  [surface] <-(prev)- [node] -(next)-> [bottom]
  */
 
-// #pragma once
+#pragma once
 
 #include <iostream>
 #include <iterator>
+
+#include "ForkChain.hpp"
+#include "ForkExport.hpp"
+#include "ForkStats.hpp"
+#include "ForkValueIndex.hpp"
 using namespace std;
 
 template <typename T>
 class ForkStack {
+public:
+  using value_type = T;
+
 private:
-  class Node {
-  public:
-    T data;
-    Node *upper = nullptr;
-    Node *lower = nullptr;
-    explicit Node(const T &data) { this->data = data; }
-  };
-  Node *bottom  = nullptr;
-  Node *surface = nullptr;
-  int size      = 0;
+  using stats = ForkStatsOf<ForkStack>;  // no-op unless FORK_STL_STATS
+  using Node  = ForkChainNode<T>;        // next: toward the bottom
+
+  Node *bottom                   = nullptr;
+  Node *surface                  = nullptr;
+  int size                       = 0;
+  ForkValueIndex<T> *value_index = nullptr;  // from the surface down
 
 public:
   // constructor and destructor
@@ -31,10 +36,13 @@ public:
   ~ForkStack();
   ForkStack(const ForkStack &other);
   ForkStack(ForkStack &&other) noexcept;
+  explicit ForkStack(ForkChain<T> &&chain);  // adopts the nodes, head on top
+  template <ForkChainSource<T> Source>
+  explicit ForkStack(Source &&from);  // steals a ForkList / ForkQueue, O(1)
 
   // operational functions
   void push(const T &data);       // push a value into the stack
-  [[nodiscard]] T &pop();         // remove the surface node then return value
+  [[nodiscard]] T pop();          // remove the surface node then return value
   void pop_without_return();      // remove the surface node
   [[nodiscard]] T &return_top();  // show the top of the stack
   void erase();                   // empty the stack, release all nodes
@@ -44,6 +52,17 @@ public:
   [[nodiscard]] int get_index(const T &value) const;
   [[nodiscard]] int get_size() const;
   void echo();
+  void export_to(ForkExport &out) const;  // surface to bottom, one record
+
+  // opt-in value index, get_index becomes a hash probe (ForkValueIndex.hpp)
+  void enable_index(const int &bloom_bits = 0);  // bloom_bits 0: no filter
+  void disable_index();
+  void rebuild_index();  // after writes through get_element / operator[]
+  [[nodiscard]] bool is_indexed() const;
+
+  // node handoff without copies (ForkChain.hpp), O(1) unless indexed
+  ForkChain<T> release_chain();           // give every node away, top first
+  void splice_top(ForkChain<T> &&chain);  // push a batch, its head on top
 
   // iterator
   class iterator {
@@ -55,11 +74,11 @@ public:
     explicit iterator(Node *node) : node(node) {}
     T &operator*() { return node->data; }
     iterator &operator++() {
-      node = node->lower;
+      node = node->next;
       return *this;
     }
     iterator &operator--() {
-      node = node->upper;
+      node = node->prev;
       return *this;
     }
   };
@@ -89,55 +108,64 @@ ForkStack<T>::~ForkStack() {
   Node *curr = surface;
   while (curr != nullptr) {
     Node *temp = curr;
-    curr       = curr->lower;
+    curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
+  delete value_index;
 }
 template <typename T>
 ForkStack<T>::ForkStack(const ForkStack &other) {
-  Node *curr = other.surface;
+  Node *curr = other.bottom;
   while (curr != nullptr) {
     push(curr->data);
-    curr = curr->lower;
+    curr = curr->prev;
+  }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
   }
 }
 template <typename T>
 ForkStack<T>::ForkStack(ForkStack &&other) noexcept {
-  surface       = other.surface;
-  bottom        = other.bottom;
-  size          = other.size;
-  other.surface = nullptr;
-  other.bottom  = nullptr;
-  other.size    = 0;
+  surface           = other.surface;
+  bottom            = other.bottom;
+  size              = other.size;
+  value_index       = other.value_index;
+  other.surface     = nullptr;
+  other.bottom      = nullptr;
+  other.size        = 0;
+  other.value_index = nullptr;
 }
 
 // operational functions
 template <typename T>
 void ForkStack<T>::push(const T &data) {
   Node *new_node = new Node(data);
+  stats::allocate(sizeof(Node));
+  stats::elements(1);
   if (surface == nullptr) {
     surface = new_node;
     bottom  = new_node;
   } else {
-    new_node->lower = surface;
-    surface->upper  = new_node;
-    surface         = new_node;
+    new_node->next = surface;
+    surface->prev  = new_node;
+    surface        = new_node;
+  }
+  if (value_index != nullptr) {
+    value_index->push_front(new_node->data);
   }
   size++;
+  stats::shape(size, size);
 }
 template <typename T>
-T &ForkStack<T>::pop() {
+T ForkStack<T>::pop() {
   if (surface == nullptr) {
     throw std::out_of_range("stack is empty");
   }
-  Node *temp = surface;
-  surface    = surface->lower;
-  if (surface != nullptr) {
-    surface->upper = nullptr;
-  }
-  delete temp;
-  size--;
-  return surface->data;
+  T data = surface->data;
+  pop_without_return();
+  return data;
 }
 template <typename T>
 T &ForkStack<T>::return_top() {
@@ -151,12 +179,17 @@ void ForkStack<T>::erase() {
   Node *curr = surface;
   while (curr != nullptr) {
     Node *temp = curr;
-    curr       = curr->lower;
+    curr       = curr->next;
     delete temp;
+    stats::release(sizeof(Node));
+    stats::elements(-1);
   }
   surface = nullptr;
   bottom  = nullptr;
   size    = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
 }
 template <typename T>
 void ForkStack<T>::clear() {
@@ -169,8 +202,9 @@ T &ForkStack<T>::get_element(const int &index) {
   }
   Node *curr = surface;
   for (int i = 0; i < index; i++) {
-    curr = curr->lower;
+    curr = curr->next;
   }
+  stats::walk(index);
   return curr->data;
 }
 template <typename T>
@@ -180,27 +214,112 @@ void ForkStack<T>::set_element(const int &index, const T &data) {
   }
   Node *curr = surface;
   for (int i = 0; i < index; i++) {
-    curr = curr->lower;
+    curr = curr->next;
+  }
+  stats::walk(index);
+  if (value_index != nullptr) {
+    value_index->replace(index, curr->data, data);
   }
   curr->data = data;
 }
 template <typename T>
 int ForkStack<T>::get_index(const T &value) const {
+  if (value_index != nullptr) {
+    return value_index->first(value);
+  }
   Node *curr = surface;
   int index  = 0;
   while (curr != nullptr) {
     if (curr->data == value) {
+      stats::walk(index + 1);
       return index;
     }
-    curr = curr->lower;
+    curr = curr->next;
     index++;
   }
+  stats::walk(index);
   return -1;
 }
 template <typename T>
 int ForkStack<T>::get_size() const {
   return size;
 }
+template <typename T>
+void ForkStack<T>::enable_index(const int &bloom_bits) {
+  delete value_index;
+  value_index = new ForkValueIndex<T>(bloom_bits);
+  rebuild_index();
+}
+template <typename T>
+void ForkStack<T>::disable_index() {
+  delete value_index;
+  value_index = nullptr;
+}
+template <typename T>
+void ForkStack<T>::rebuild_index() {
+  if (value_index == nullptr) {
+    return;
+  }
+  value_index->clear();
+  for (Node *curr = surface; curr != nullptr; curr = curr->next) {
+    value_index->push_back(curr->data);
+  }
+}
+template <typename T>
+bool ForkStack<T>::is_indexed() const {
+  return value_index != nullptr;
+}
+
+// chain handoff (ForkChain.hpp)
+template <typename T>
+ForkStack<T>::ForkStack(ForkChain<T> &&chain) {
+  surface = chain.data_head();
+  bottom  = chain.data_tail();
+  size    = chain.get_size();
+  chain.release();
+  stats::adopt(size * static_cast<long long>(sizeof(Node)), size);
+  stats::shape(size, size);
+}
+template <typename T>
+template <ForkChainSource<T> Source>
+ForkStack<T>::ForkStack(Source &&from) : ForkStack(from.release_chain()) {}
+template <typename T>
+ForkChain<T> ForkStack<T>::release_chain() {
+  ForkChain<T> chain(surface, bottom, size);
+  stats::adopt(-size * static_cast<long long>(sizeof(Node)), -size);
+  surface = nullptr;
+  bottom  = nullptr;
+  size    = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
+  return chain;
+}
+template <typename T>
+void ForkStack<T>::splice_top(ForkChain<T> &&chain) {
+  if (chain.is_empty()) {
+    return;
+  }
+  Node *first = chain.data_head();
+  Node *last  = chain.data_tail();
+  int count   = chain.get_size();
+  chain.release();
+  stats::adopt(count * static_cast<long long>(sizeof(Node)), count);
+  if (bottom == nullptr) {
+    bottom = last;
+  } else {
+    last->next    = surface;
+    surface->prev = last;
+  }
+  surface = first;
+  if (value_index != nullptr) {
+    for (Node *curr = last; curr != nullptr; curr = curr->prev) {
+      value_index->push_front(curr->data);
+    }
+  }
+  size += count;
+  stats::shape(size, size);
+}
 
 // operator overloading
 template <typename T>
@@ -208,11 +327,15 @@ ForkStack<T> &ForkStack<T>::operator=(const ForkStack &other) {
   if (this == &other) {
     return *this;
   }
+  disable_index();  // the index follows the contents
   erase();
-  Node *curr = other.surface;
+  Node *curr = other.bottom;
   while (curr != nullptr) {
     push(curr->data);
-    curr = curr->lower;
+    curr = curr->prev;
+  }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
   }
   return *this;
 }
@@ -221,12 +344,16 @@ ForkStack<T> &ForkStack<T>::operator=(ForkStack &&other) noexcept {
   if (this == &other) {
     return *this;
   }
-  surface       = other.surface;
-  bottom        = other.bottom;
-  size          = other.size;
-  other.surface = nullptr;
-  other.bottom  = nullptr;
-  other.size    = 0;
+  erase();
+  delete value_index;
+  surface           = other.surface;
+  bottom            = other.bottom;
+  size              = other.size;
+  value_index       = other.value_index;
+  other.surface     = nullptr;
+  other.bottom      = nullptr;
+  other.size        = 0;
+  other.value_index = nullptr;
   return *this;
 }
 template <typename T>
@@ -240,8 +367,8 @@ bool ForkStack<T>::operator==(const ForkStack &other) const {
     if (curr->data != curr2->data) {
       return false;
     }
-    curr  = curr->lower;
-    curr2 = curr2->lower;
+    curr  = curr->next;
+    curr2 = curr2->next;
   }
   return true;
 }
@@ -256,8 +383,9 @@ T &ForkStack<T>::operator[](const int &index) {
   }
   Node *curr = surface;
   for (int i = 0; i < index; i++) {
-    curr = curr->lower;
+    curr = curr->next;
   }
+  stats::walk(index);
   return curr->data;
 }
 template <typename T>
@@ -267,8 +395,9 @@ const T &ForkStack<T>::operator[](const int &index) const {
   }
   Node *curr = surface;
   for (int i = 0; i < index; i++) {
-    curr = curr->lower;
+    curr = curr->next;
   }
+  stats::walk(index);
   return curr->data;
 }
 template <typename T>
@@ -302,11 +431,19 @@ void ForkStack<T>::echo() {
   Node *curr = surface;
   while (curr != nullptr) {
     std::cout << curr->data << ", ";
-    curr = curr->lower;
+    curr = curr->next;
   }
   std::cout << "\b\b  \b\b" << std::endl;
   std::cout << std::endl;
 }
+// export_to
+template <typename T>
+void ForkStack<T>::export_to(ForkExport &out) const {
+  for (Node *curr = surface; curr != nullptr; curr = curr->next) {
+    out.add(curr->data);
+  }
+  out.end_record();
+}
 
 // added functions
 template <typename T>
@@ -314,8 +451,18 @@ void ForkStack<T>::pop_without_return() {
   if (surface == nullptr) {
     throw std::out_of_range("stack is empty");
   }
+  if (value_index != nullptr) {
+    value_index->pop_front(surface->data);
+  }
   Node *temp = surface;
-  surface    = surface->lower;
+  surface    = surface->next;
+  if (surface != nullptr) {
+    surface->prev = nullptr;
+  } else {
+    bottom = nullptr;
+  }
   delete temp;
+  stats::release(sizeof(Node));
+  stats::elements(-1);
   size--;
 }
@@ -0,0 +1,252 @@
+// opt-in instrumentation counters for the container hot paths
+// build with -DFORK_STL_STATS (cmake -DFORK_STL_STATS=ON) to enable them,
+// otherwise every hook below is an empty inline function and costs nothing
+//
+// each container type (ForkVector<int>, ForkQueue<std::string>, ...) gets
+// one global ForkStats, registered on first use, and ForkStatsRegistry can
+// dump all of them at any time from a running process
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+
+#include <cstdlib>
+#endif
+
+#ifdef FORK_STL_STATS
+inline constexpr bool fork_stats_enabled = true;
+#else
+inline constexpr bool fork_stats_enabled = false;
+#endif
+
+class ForkStats {
+public:
+  std::string name;           // demangled container type
+  long long element_size = 0;  // sizeof(T), to turn elements into bytes
+
+  std::atomic<long long> allocations{0};    // buffers or nodes allocated
+  std::atomic<long long> frees{0};          // buffers or nodes released
+  std::atomic<long long> reallocations{0};  // buffer replaced by a larger one
+  std::atomic<long long> bytes_moved{0};    // copied over on reallocation
+  std::atomic<long long> live_bytes{0};     // allocated and not yet freed
+  std::atomic<long long> live_elements{0};  // constructed elements in use
+  std::atomic<long long> peak_size{0};      // largest size of one instance
+  std::atomic<long long> peak_capacity{0};  // largest capacity of one instance
+  std::atomic<long long> walks{0};          // linear walks (index / search)
+  std::atomic<long long> walk_steps{0};     // nodes or slots visited by them
+  std::atomic<long long> max_walk{0};       // longest single walk
+
+  ForkStats *next = nullptr;  // registry link
+
+  ForkStats(const std::string &name, const long long &element_size);
+  static void raise(std::atomic<long long> &peak, const long long &value);
+  void dump(std::ostream &out) const;
+};
+
+class ForkStatsRegistry {
+private:
+  std::atomic<ForkStats *> head{nullptr};
+
+public:
+  static ForkStatsRegistry &instance();
+  void add(ForkStats *stats);            // lock-free, stats live forever
+  void dump(std::ostream &out) const;    // one "name key=value ..." line each
+  [[nodiscard]] std::string scrape() const;  // dump() into a string
+};
+
+// hooks called by the containers, Container is the instrumented type
+// they are constexpr and do nothing during constant evaluation
+template <typename Container>
+class ForkStatsOf {
+public:
+  static ForkStats &get();
+  static constexpr void allocate(const long long &bytes);
+  static constexpr void release(const long long &bytes);
+  static constexpr void reallocate(const long long &old_bytes,
+                                   const long long &new_bytes,
+                                   const long long &moved_bytes);
+  static constexpr void elements(const long long &delta);
+  static constexpr void adopt(const long long &bytes,   // nodes handed over,
+                              const long long &count);  // < 0 when given
+  static constexpr void shape(const long long &size,
+                              const long long &capacity);
+  static constexpr void walk(const long long &steps);
+};
+
+// demangled name of T (falls back to the mangled one)
+template <typename T>
+std::string fork_type_name() {
+  const char *mangled = typeid(T).name();
+#if defined(__GNUC__) || defined(__clang__)
+  int status      = 0;
+  char *demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  if (status == 0 && demangled != nullptr) {
+    std::string name(demangled);
+    std::free(demangled);
+    return name;
+  }
+#endif
+  return mangled;
+}
+
+// ForkStats
+inline ForkStats::ForkStats(const std::string &name,
+                            const long long &element_size)
+    : name(name), element_size(element_size) {}
+// raise (lock-free max)
+inline void ForkStats::raise(std::atomic<long long> &peak,
+                             const long long &value) {
+  long long seen = peak.load(std::memory_order_relaxed);
+  while (seen < value && !peak.compare_exchange_weak(
+                             seen, value, std::memory_order_relaxed)) {
+  }
+}
+// dump
+inline void ForkStats::dump(std::ostream &out) const {
+  auto get = [](const std::atomic<long long> &counter) {
+    return counter.load(std::memory_order_relaxed);
+  };
+  long long wasted = get(live_bytes) - get(live_elements) * element_size;
+  out << name << " allocations=" << get(allocations)
+      << " frees=" << get(frees) << " reallocations=" << get(reallocations)
+      << " bytes_moved=" << get(bytes_moved)
+      << " live_bytes=" << get(live_bytes)
+      << " live_elements=" << get(live_elements)
+      << " wasted_bytes=" << (wasted > 0 ? wasted : 0)
+      << " peak_size=" << get(peak_size)
+      << " peak_capacity=" << get(peak_capacity) << " walks=" << get(walks)
+      << " walk_steps=" << get(walk_steps) << " max_walk=" << get(max_walk)
+      << std::endl;
+}
+
+// ForkStatsRegistry
+inline ForkStatsRegistry &ForkStatsRegistry::instance() {
+  static ForkStatsRegistry registry;
+  return registry;
+}
+// add
+inline void ForkStatsRegistry::add(ForkStats *stats) {
+  ForkStats *first = head.load(std::memory_order_relaxed);
+  do {
+    stats->next = first;
+  } while (!head.compare_exchange_weak(first, stats, std::memory_order_release,
+                                       std::memory_order_relaxed));
+}
+// dump
+inline void ForkStatsRegistry::dump(std::ostream &out) const {
+  if constexpr (!fork_stats_enabled) {
+    out << "# fork stats disabled, rebuild with FORK_STL_STATS" << std::endl;
+  }
+  for (ForkStats *curr = head.load(std::memory_order_acquire);
+       curr != nullptr; curr = curr->next) {
+    curr->dump(out);
+  }
+}
+// scrape
+inline std::string ForkStatsRegistry::scrape() const {
+  std::ostringstream out;
+  dump(out);
+  return out.str();
+}
+
+// ForkStatsOf
+template <typename Container>
+ForkStats &ForkStatsOf<Container>::get() {
+  static ForkStats *stats = [] {
+    auto *created = new ForkStats(
+        fork_type_name<Container>(),
+        static_cast<long long>(sizeof(typename Container::value_type)));
+    ForkStatsRegistry::instance().add(created);
+    return created;
+  }();
+  return *stats;
+}
+// allocate
+template <typename Container>
+constexpr void ForkStatsOf<Container>::allocate(const long long &bytes) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      ForkStats &stats = get();
+      stats.allocations.fetch_add(1, std::memory_order_relaxed);
+      stats.live_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
+}
+// release
+template <typename Container>
+constexpr void ForkStatsOf<Container>::release(const long long &bytes) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      ForkStats &stats = get();
+      stats.frees.fetch_add(1, std::memory_order_relaxed);
+      stats.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+  }
+}
+// reallocate
+template <typename Container>
+constexpr void ForkStatsOf<Container>::reallocate(
+    const long long &old_bytes, const long long &new_bytes,
+    const long long &moved_bytes) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      ForkStats &stats = get();
+      stats.reallocations.fetch_add(1, std::memory_order_relaxed);
+      stats.bytes_moved.fetch_add(moved_bytes, std::memory_order_relaxed);
+      stats.live_bytes.fetch_add(new_bytes - old_bytes,
+                                 std::memory_order_relaxed);
+    }
+  }
+}
+// elements
+template <typename Container>
+constexpr void ForkStatsOf<Container>::elements(const long long &delta) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      get().live_elements.fetch_add(delta, std::memory_order_relaxed);
+    }
+  }
+}
+// adopt (live nodes change owner, nothing is allocated or freed)
+template <typename Container>
+constexpr void ForkStatsOf<Container>::adopt(const long long &bytes,
+                                             const long long &count) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      ForkStats &stats = get();
+      stats.live_bytes.fetch_add(bytes, std::memory_order_relaxed);
+      stats.live_elements.fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+}
+// shape
+template <typename Container>
+constexpr void ForkStatsOf<Container>::shape(const long long &size,
+                                             const long long &capacity) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      ForkStats &stats = get();
+      ForkStats::raise(stats.peak_size, size);
+      ForkStats::raise(stats.peak_capacity, capacity);
+    }
+  }
+}
+// walk
+template <typename Container>
+constexpr void ForkStatsOf<Container>::walk(const long long &steps) {
+  if constexpr (fork_stats_enabled) {
+    if (!std::is_constant_evaluated()) {
+      ForkStats &stats = get();
+      stats.walks.fetch_add(1, std::memory_order_relaxed);
+      stats.walk_steps.fetch_add(steps, std::memory_order_relaxed);
+      ForkStats::raise(stats.max_walk, steps);
+    }
+  }
+}
@@ -0,0 +1,158 @@
+// lock-free work-stealing deque (Chase-Lev)
+// the owner thread pushes and pops at the bottom (LIFO)
+// any other thread steals from the top (FIFO)
+
+/*
+ *  [top] <-(steal)- [ ... ] -(push / pop)-> [bottom]
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "ForkVector.hpp"
+
+template <typename T>
+class ForkStealDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "ForkStealDeque<T> requires a trivially copyable T "
+                "(store pointers to larger payloads)");
+
+private:
+  // circular buffer, replaced (never resized in place) on growth
+  class Array {
+  public:
+    std::int64_t capacity;
+    std::int64_t mask;
+    std::atomic<T> *slots;
+    explicit Array(const std::int64_t &capacity)
+        : capacity(capacity), mask(capacity - 1) {
+      slots = new std::atomic<T>[capacity];
+    }
+    ~Array() { delete[] slots; }
+    T get(const std::int64_t &i) const {
+      return slots[i & mask].load(std::memory_order_relaxed);
+    }
+    void put(const std::int64_t &i, const T &value) {
+      slots[i & mask].store(value, std::memory_order_relaxed);
+    }
+    Array *grow(const std::int64_t &top, const std::int64_t &bottom) const {
+      Array *bigger = new Array(capacity * 2);
+      for (std::int64_t i = top; i < bottom; i++) {
+        bigger->put(i, get(i));
+      }
+      return bigger;
+    }
+  };
+
+  alignas(64) std::atomic<std::int64_t> top{0};     // stolen from here
+  alignas(64) std::atomic<std::int64_t> bottom{0};  // owner works here
+  std::atomic<Array *> array{nullptr};
+  ForkVector<Array *> retired;  // old buffers, thieves may still read them
+
+public:
+  // constructor and destructor
+  explicit ForkStealDeque(const int &init_capacity = 64);
+  ~ForkStealDeque();
+  ForkStealDeque(const ForkStealDeque &other)            = delete;
+  ForkStealDeque &operator=(const ForkStealDeque &other) = delete;
+
+  // owner thread only
+  void push(const T &value);  // push at the bottom
+  bool pop(T &out);           // pop from the bottom, false if empty
+
+  // any thread
+  bool steal(T &out);  // take from the top, false if empty or lost a race
+  [[nodiscard]] int get_size() const;  // approximate when used concurrently
+  [[nodiscard]] bool is_empty() const;
+};
+
+// constructor
+template <typename T>
+ForkStealDeque<T>::ForkStealDeque(const int &init_capacity) {
+  std::int64_t capacity = 1;
+  while (capacity < init_capacity) {
+    capacity *= 2;
+  }
+  array.store(new Array(capacity), std::memory_order_relaxed);
+}
+// destructor
+template <typename T>
+ForkStealDeque<T>::~ForkStealDeque() {
+  delete array.load(std::memory_order_relaxed);
+  for (int i = 0; i < retired.GetSize(); i++) {
+    delete retired[i];
+  }
+}
+
+// push
+template <typename T>
+void ForkStealDeque<T>::push(const T &value) {
+  std::int64_t b = bottom.load(std::memory_order_relaxed);
+  std::int64_t t = top.load(std::memory_order_acquire);
+  Array *a       = array.load(std::memory_order_relaxed);
+  if (b - t > a->capacity - 1) {
+    Array *bigger = a->grow(t, b);
+    retired.push_back(a);
+    array.store(bigger, std::memory_order_release);
+    a = bigger;
+  }
+  a->put(b, value);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom.store(b + 1, std::memory_order_relaxed);
+}
+// pop
+template <typename T>
+bool ForkStealDeque<T>::pop(T &out) {
+  std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+  Array *a       = array.load(std::memory_order_relaxed);
+  bottom.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t t = top.load(std::memory_order_relaxed);
+  if (t > b) {
+    // already empty
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return false;
+  }
+  out = a->get(b);
+  if (t == b) {
+    // last element, race against thieves for it
+    bool won = top.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+  return true;
+}
+// steal
+template <typename T>
+bool ForkStealDeque<T>::steal(T &out) {
+  std::int64_t t = top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t b = bottom.load(std::memory_order_acquire);
+  if (t >= b) {
+    return false;
+  }
+  Array *a    = array.load(std::memory_order_acquire);
+  T candidate = a->get(t);
+  if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                   std::memory_order_relaxed)) {
+    return false;
+  }
+  out = candidate;
+  return true;
+}
+// get_size
+template <typename T>
+int ForkStealDeque<T>::get_size() const {
+  std::int64_t b = bottom.load(std::memory_order_relaxed);
+  std::int64_t t = top.load(std::memory_order_relaxed);
+  return b > t ? static_cast<int>(b - t) : 0;
+}
+// is_empty
+template <typename T>
+bool ForkStealDeque<T>::is_empty() const {
+  return get_size() == 0;
+}
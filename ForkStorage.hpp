@@ -0,0 +1,115 @@
+// storage policies for ForkVector, the second template parameter:
+//   ForkVector<T>                                 new T[], as it always was
+//   ForkVector<T, ForkAlignedStorage<64>>         every buffer on a 64-byte
+//                                                 boundary (SIMD loads never
+//                                                 straddle a cache line)
+//   ForkVector<T, ForkHugePageStorage<>>          64-byte aligned, and buffers
+//                                                 of 2 MiB or more are 2 MiB
+//                                                 aligned and madvise'd as
+//                                                 transparent huge pages
+//
+// a policy hands out n constructed (default-initialized) elements and takes
+// them back by the same n; in constant evaluation every policy falls back
+// to new T[], so the constexpr ForkVector core keeps working
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+class ForkDefaultStorage {
+public:
+  template <typename T>
+  static constexpr T *allocate(const int &n) {
+    return new T[n];
+  }
+  template <typename T>
+  static constexpr void deallocate(T *data, const int &) {
+    delete[] data;
+  }
+};
+
+template <std::size_t Alignment>
+class ForkAlignedStorage {
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "alignment must be a power of two");
+
+public:
+  static constexpr std::size_t alignment = Alignment;
+
+  template <typename T>
+  static constexpr T *allocate(const int &n) {
+    if (std::is_constant_evaluated()) {
+      return new T[n];
+    }
+    return construct<T>(raw(n * sizeof(T), align_for<T>()), n);
+  }
+  template <typename T>
+  static constexpr void deallocate(T *data, const int &n) {
+    if (std::is_constant_evaluated()) {
+      delete[] data;
+      return;
+    }
+    if (data != nullptr) {
+      std::destroy_n(data, n);
+      ::operator delete(data, std::align_val_t(align_for<T>()));
+    }
+  }
+
+protected:
+  template <typename T>
+  static constexpr std::size_t align_for() {
+    return Alignment > alignof(T) ? Alignment : alignof(T);
+  }
+  static void *raw(const std::size_t &bytes, const std::size_t &align) {
+    return ::operator new(bytes > 0 ? bytes : 1, std::align_val_t(align));
+  }
+  template <typename T>
+  static T *construct(void *memory, const int &n) {
+    T *data = static_cast<T *>(memory);
+    std::uninitialized_default_construct_n(data, n);
+    return data;
+  }
+};
+
+template <std::size_t Threshold = std::size_t(2) << 20>
+class ForkHugePageStorage : public ForkAlignedStorage<64> {
+public:
+  static constexpr std::size_t huge_page = std::size_t(2) << 20;  // x86-64
+
+  template <typename T>
+  static constexpr T *allocate(const int &n) {
+    std::size_t bytes = n * sizeof(T);
+    if (std::is_constant_evaluated() || bytes < Threshold) {
+      return ForkAlignedStorage<64>::allocate<T>(n);
+    }
+    // whole huge pages, so the kernel can back all of it with 2 MiB pages
+    std::size_t rounded = (bytes + huge_page - 1) / huge_page * huge_page;
+    void *memory        = raw(rounded, huge_page);
+#if defined(MADV_HUGEPAGE)
+    madvise(memory, rounded, MADV_HUGEPAGE);  // only a hint, errors are fine
+#endif
+    return construct<T>(memory, n);
+  }
+  template <typename T>
+  static constexpr void deallocate(T *data, const int &n) {
+    std::size_t bytes = n * sizeof(T);
+    if (std::is_constant_evaluated() || bytes < Threshold) {
+      ForkAlignedStorage<64>::deallocate(data, n);
+      return;
+    }
+    if (data != nullptr) {
+      std::destroy_n(data, n);
+      ::operator delete(data, std::align_val_t(huge_page));
+    }
+  }
+};
+
+template <typename T, typename Storage = ForkDefaultStorage>
+class ForkVector;
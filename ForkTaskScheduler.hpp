@@ -0,0 +1,294 @@
+// work-stealing task scheduler
+// every worker owns a ForkStealDeque, tasks spawned by a worker go to its
+// own deque, idle workers steal from a random victim and then park
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "ForkQueue.hpp"
+#include "ForkStealDeque.hpp"
+#include "ForkVector.hpp"
+
+class ForkTaskScheduler {
+public:
+  using Task = std::function<void()>;
+
+private:
+  class Worker {
+  public:
+    ForkStealDeque<Task *> deque;
+    std::thread thread;
+    std::uint64_t seed = 0;  // xorshift state for victim selection
+  };
+  ForkVector<Worker *> workers;
+  ForkQueue<Task *> injected;         // tasks submitted from outside
+  std::mutex injected_mtx;            // guards injected
+  std::atomic<int> injected_size{0};  // lock-free emptiness check
+
+  std::atomic<int> pending{0};   // submitted but not yet finished
+  std::atomic<int> sleeping{0};  // parked workers
+  std::atomic<bool> stopping{false};
+  std::uint64_t epoch = 0;  // bumped on every wake-up, guarded by park_mtx
+  std::mutex park_mtx;
+  std::condition_variable park_cv;  // idle workers sleep here
+  std::condition_variable idle_cv;  // wait_idle() sleeps here
+
+  static thread_local ForkTaskScheduler *current_scheduler;
+  static thread_local int current_worker;
+
+  void worker_loop(const int &index);
+  Task *find_task(const int &index);
+  Task *steal_task(const int &index);
+  bool has_work() const;
+  void execute(Task *task);
+  void wake_one();
+
+public:
+  // constructor and destructor
+  explicit ForkTaskScheduler(const int &num_workers = 0);  // 0 = all cores
+  ~ForkTaskScheduler();
+  ForkTaskScheduler(const ForkTaskScheduler &other)            = delete;
+  ForkTaskScheduler &operator=(const ForkTaskScheduler &other) = delete;
+
+  void submit(Task task);  // local deque on a worker, injected otherwise
+  bool run_one();          // execute one ready task on the calling thread
+  void wait_idle();        // block until every submitted task finished
+  [[nodiscard]] int get_num_workers() const;
+  [[nodiscard]] int get_pending() const;
+};
+
+// fork-join helper: run() children, then wait() for all of them
+// wait() executes other tasks instead of blocking, so nesting is safe
+class ForkTaskGroup {
+private:
+  ForkTaskScheduler &scheduler;
+  std::atomic<int> pending{0};
+
+public:
+  explicit ForkTaskGroup(ForkTaskScheduler &scheduler);
+  ~ForkTaskGroup();
+  ForkTaskGroup(const ForkTaskGroup &other)            = delete;
+  ForkTaskGroup &operator=(const ForkTaskGroup &other) = delete;
+
+  void run(ForkTaskScheduler::Task task);
+  void wait();
+};
+
+inline thread_local ForkTaskScheduler *ForkTaskScheduler::current_scheduler =
+    nullptr;
+inline thread_local int ForkTaskScheduler::current_worker = -1;
+
+// constructor
+inline ForkTaskScheduler::ForkTaskScheduler(const int &num_workers) {
+  int n = num_workers;
+  if (n <= 0) {
+    n = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  if (n <= 0) {
+    n = 1;
+  }
+  workers.preAlloc(n);
+  for (int i = 0; i < n; i++) {
+    Worker *worker = new Worker;
+    worker->seed   = 0x9E3779B97F4A7C15ULL * static_cast<std::uint64_t>(i + 1);
+    workers.push_back(worker);
+  }
+  // start threads only after every deque exists, they steal from each other
+  for (int i = 0; i < n; i++) {
+    workers[i]->thread = std::thread([this, i] { worker_loop(i); });
+  }
+}
+// destructor
+inline ForkTaskScheduler::~ForkTaskScheduler() {
+  wait_idle();
+  {
+    std::lock_guard<std::mutex> lock(park_mtx);
+    stopping.store(true);
+    ++epoch;
+  }
+  park_cv.notify_all();
+  // join everyone before freeing, a late thief may still touch any deque
+  for (int i = 0; i < workers.GetSize(); i++) {
+    workers[i]->thread.join();
+  }
+  for (int i = 0; i < workers.GetSize(); i++) {
+    delete workers[i];
+  }
+}
+
+// submit
+inline void ForkTaskScheduler::submit(Task task) {
+  Task *heap_task = new Task(std::move(task));
+  pending.fetch_add(1);
+  if (current_scheduler == this && current_worker >= 0) {
+    workers[current_worker]->deque.push(heap_task);
+  } else {
+    std::lock_guard<std::mutex> lock(injected_mtx);
+    injected.push(heap_task);
+    injected_size.fetch_add(1);
+  }
+  wake_one();
+}
+// run_one
+inline bool ForkTaskScheduler::run_one() {
+  int index  = current_scheduler == this ? current_worker : -1;
+  Task *task = find_task(index);
+  if (task == nullptr) {
+    return false;
+  }
+  execute(task);
+  return true;
+}
+// wait_idle (from outside the scheduler, tasks use ForkTaskGroup instead)
+inline void ForkTaskScheduler::wait_idle() {
+  std::unique_lock<std::mutex> lock(park_mtx);
+  idle_cv.wait(lock, [this] { return pending.load() == 0; });
+}
+// get_num_workers
+inline int ForkTaskScheduler::get_num_workers() const {
+  return workers.GetSize();
+}
+// get_pending
+inline int ForkTaskScheduler::get_pending() const {
+  return pending.load();
+}
+
+// worker_loop
+inline void ForkTaskScheduler::worker_loop(const int &index) {
+  current_scheduler = this;
+  current_worker    = index;
+  const int spins   = 64;
+  while (!stopping.load(std::memory_order_relaxed)) {
+    Task *task = nullptr;
+    for (int i = 0; i < spins && task == nullptr; i++) {
+      task = find_task(index);
+      if (task == nullptr) {
+        std::this_thread::yield();
+      }
+    }
+    if (task != nullptr) {
+      execute(task);
+      continue;
+    }
+    // park: register first, then re-check, so a concurrent submit()
+    // either sees us sleeping or we see its task
+    std::unique_lock<std::mutex> lock(park_mtx);
+    std::uint64_t seen = epoch;
+    sleeping.fetch_add(1);
+    lock.unlock();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool work_arrived = has_work();
+    lock.lock();
+    if (!work_arrived) {
+      park_cv.wait(lock, [this, seen] {
+        return stopping.load(std::memory_order_relaxed) || epoch != seen;
+      });
+    }
+    sleeping.fetch_sub(1);
+  }
+  current_scheduler = nullptr;
+  current_worker    = -1;
+}
+// find_task (own deque first, then the injected queue, then steal)
+inline ForkTaskScheduler::Task *ForkTaskScheduler::find_task(
+    const int &index) {
+  Task *task = nullptr;
+  if (index >= 0 && workers[index]->deque.pop(task)) {
+    return task;
+  }
+  if (injected_size.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(injected_mtx);
+    if (injected.get_size() > 0) {
+      task = injected.data_head()->data;
+      injected.quit_head();
+      injected_size.fetch_sub(1);
+      return task;
+    }
+  }
+  return steal_task(index);
+}
+// steal_task (start at a random victim, try each worker once)
+inline ForkTaskScheduler::Task *ForkTaskScheduler::steal_task(
+    const int &index) {
+  int n = workers.GetSize();
+  int start;
+  if (index >= 0) {
+    std::uint64_t &x = workers[index]->seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    start = static_cast<int>(x % static_cast<std::uint64_t>(n));
+  } else {
+    start = 0;
+  }
+  Task *task = nullptr;
+  for (int i = 0; i < n; i++) {
+    int victim = (start + i) % n;
+    if (victim != index && workers[victim]->deque.steal(task)) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+// has_work
+inline bool ForkTaskScheduler::has_work() const {
+  if (injected_size.load() > 0) {
+    return true;
+  }
+  for (int i = 0; i < workers.GetSize(); i++) {
+    if (!workers.GetPtr()[i]->deque.is_empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+// execute
+inline void ForkTaskScheduler::execute(Task *task) {
+  (*task)();
+  delete task;
+  if (pending.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock(park_mtx);
+    idle_cv.notify_all();
+  }
+}
+// wake_one (skip the mutex entirely when nobody is parked)
+inline void ForkTaskScheduler::wake_one() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load() == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(park_mtx);
+    ++epoch;
+  }
+  park_cv.notify_one();
+}
+
+// ForkTaskGroup
+inline ForkTaskGroup::ForkTaskGroup(ForkTaskScheduler &scheduler)
+    : scheduler(scheduler) {}
+inline ForkTaskGroup::~ForkTaskGroup() {
+  wait();
+}
+// run
+inline void ForkTaskGroup::run(ForkTaskScheduler::Task task) {
+  pending.fetch_add(1);
+  scheduler.submit([this, task = std::move(task)] {
+    task();
+    pending.fetch_sub(1, std::memory_order_release);
+  });
+}
+// wait
+inline void ForkTaskGroup::wait() {
+  while (pending.load(std::memory_order_acquire) > 0) {
+    if (!scheduler.run_one()) {
+      std::this_thread::yield();
+    }
+  }
+}
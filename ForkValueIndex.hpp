@@ -0,0 +1,319 @@
+// opt-in value index behind GetIndex / get_index of the sequence containers
+// a hash map from each value to the positions holding it, kept up to date by
+// the owner's push / pop / erase / SetElement, so a first-index or
+// membership query is one hash probe instead of a scan:
+//   ForkVector<int> ids;
+//   ids.EnableIndex();          // ForkList too; enable_index() on
+//   ...                         // ForkStack / ForkQueue
+//   ids.GetIndex(42);           // same call, O(1) expected
+//
+// positions are stored as tickets, the front element holds ticket `front`,
+// so pushing or popping at either end renumbers nothing; an erase from the
+// middle shifts every position after it and the owner rebuilds the index
+// (that erase is O(n) already)
+//
+// an optional Bloom filter (3 probes) rejects most absent values without
+// touching the hash map; removed values leave their bits behind until they
+// outnumber both the live ones and 1/64 of the filter's bits, then the
+// filter is rebuilt from the live keys (amortized O(1) per removal)
+//
+// writes through a reference (operator[], GetElement, GetPtr) bypass the
+// index, call RebuildIndex() / rebuild_index() on the owner after them
+
+/*
+ *  values:   [ 7 | 3 | 7 | 9 ]      front = -2 (two push_fronts so far)
+ *  tickets:  7 -> { -2, 0 }   3 -> { -1 }   9 -> { 1 }
+ *  first(7) = -2 - front = 0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+
+#include "ForkBitset.hpp"
+#include "ForkHashMap.hpp"
+#include "ForkVector.hpp"
+
+// a value type the index can hold: hashable by std::hash and comparable
+template <typename T>
+concept ForkIndexable = requires(const T &a, const T &b) {
+  { std::hash<T>()(a) } -> std::convertible_to<std::size_t>;
+  { a == b } -> std::convertible_to<bool>;
+};
+
+template <typename T>
+class ForkValueIndex {
+public:
+  using value_type = T;
+
+private:
+  // tickets of one value in ascending order, [first, last) is live with
+  // slack on both sides, so push / pop at either end are O(1) amortized
+  class Tickets {
+  public:
+    ForkVector<long long> items;
+    int first = 0;
+    int last  = 0;
+    [[nodiscard]] int count() const { return last - first; }
+    [[nodiscard]] long long least() const { return items.GetPtr()[first]; }
+    void insert(const long long &ticket);
+    void erase(const long long &ticket);  // absent (stale index): no-op
+
+  private:
+    void recentre();  // live run to the middle, count() + 4 slack each side
+  };
+
+  ForkHashMap<T, Tickets> tickets;
+  ForkBitset bloom;  // empty when the filter is off
+  int bloom_mask  = 0;
+  int removed     = 0;  // values whose bits are still set in the filter
+  long long front = 0;  // ticket of position 0
+  long long back  = 0;  // ticket after the last position
+
+  static std::size_t hash_of(const T &value);
+  void mark(const T &value);
+  [[nodiscard]] bool maybe_contains(const T &value) const;
+  void add(const T &value, const long long &ticket);
+  void remove(const T &value, const long long &ticket);
+
+public:
+  // constructor and destructor
+  explicit ForkValueIndex(const int &bloom_bits = 0);  // 0: no filter
+
+  // functions
+  void push_back(const T &value);
+  void push_front(const T &value);
+  void pop_back(const T &value);   // value: the element being removed
+  void pop_front(const T &value);  // value: the element being removed
+  void replace(const int &position, const T &old_value, const T &value);
+  void clear();
+  [[nodiscard]] int first(const T &value) const;  // position or -1
+  [[nodiscard]] int count(const T &value) const;
+  [[nodiscard]] bool contains(const T &value) const;
+};
+
+// element types without std::hash or == never get an index, the owners
+// still compile against this do-nothing version
+template <typename T>
+  requires(!ForkIndexable<T>)
+class ForkValueIndex<T> {
+public:
+  explicit ForkValueIndex(const int & = 0) {
+    static_assert(ForkIndexable<T>, "indexed values need std::hash and ==");
+  }
+  void push_back(const T &) {}
+  void push_front(const T &) {}
+  void pop_back(const T &) {}
+  void pop_front(const T &) {}
+  void replace(const int &, const T &, const T &) {}
+  void clear() {}
+  [[nodiscard]] int first(const T &) const { return -1; }
+  [[nodiscard]] int count(const T &) const { return 0; }
+  [[nodiscard]] bool contains(const T &) const { return false; }
+};
+
+// Tickets
+
+// recentre (O(count), at least count() + 4 end operations apart)
+template <typename T>
+void ForkValueIndex<T>::Tickets::recentre() {
+  int n    = count();
+  int room = n + 4;
+  ForkVector<long long> moved;
+  moved.resize(room + n + room);
+  std::copy(items.GetPtr() + first, items.GetPtr() + last,
+            moved.GetPtr() + room);
+  items = std::move(moved);
+  first = room;
+  last  = room + n;
+}
+// insert
+template <typename T>
+void ForkValueIndex<T>::Tickets::insert(const long long &ticket) {
+  if (count() == 0 || ticket > items.GetPtr()[last - 1]) {
+    if (last == items.GetSize()) {
+      recentre();
+    }
+    items.GetPtr()[last++] = ticket;  // push_back
+    return;
+  }
+  if (ticket < items.GetPtr()[first]) {
+    if (first == 0) {
+      recentre();
+    }
+    items.GetPtr()[--first] = ticket;  // push_front
+    return;
+  }
+  if (last == items.GetSize()) {
+    recentre();  // replace() in the middle, shift the tail by one
+  }
+  long long *data = items.GetPtr();
+  long long *at   = std::lower_bound(data + first, data + last, ticket);
+  std::move_backward(at, data + last, data + last + 1);
+  *at = ticket;
+  ++last;
+}
+// erase
+template <typename T>
+void ForkValueIndex<T>::Tickets::erase(const long long &ticket) {
+  long long *data = items.GetPtr();
+  long long *at   = std::lower_bound(data + first, data + last, ticket);
+  if (at == data + last || *at != ticket) {
+    return;
+  }
+  if (at == data + first) {
+    ++first;
+  } else {
+    std::move(at + 1, data + last, at);
+    --last;
+  }
+  if (items.GetSize() > 64 && count() * 8 < items.GetSize()) {
+    recentre();  // give back the room a burst left behind
+  }
+}
+
+// ForkValueIndex
+
+// hash_of
+template <typename T>
+std::size_t ForkValueIndex<T>::hash_of(const T &value) {
+  std::size_t h = std::hash<T>()(value) * 0x9E3779B97F4A7C15ull;
+  return h ^ (h >> 29);
+}
+// mark (set the value's bits in the filter)
+template <typename T>
+void ForkValueIndex<T>::mark(const T &value) {
+  std::size_t h    = hash_of(value);
+  std::size_t step = (h >> 32) | 1;
+  for (int i = 0; i < 3; i++) {
+    bloom.SetElement(static_cast<int>((h + i * step) & bloom_mask), true);
+  }
+}
+// maybe_contains (false means certainly absent)
+template <typename T>
+bool ForkValueIndex<T>::maybe_contains(const T &value) const {
+  if (bloom_mask == 0) {
+    return true;
+  }
+  std::size_t h    = hash_of(value);
+  std::size_t step = (h >> 32) | 1;
+  for (int i = 0; i < 3; i++) {
+    if (!bloom[static_cast<int>((h + i * step) & bloom_mask)]) {
+      return false;
+    }
+  }
+  return true;
+}
+// add
+template <typename T>
+void ForkValueIndex<T>::add(const T &value, const long long &ticket) {
+  Tickets &list = tickets[value];
+  if (list.count() == 0 && bloom_mask != 0) {
+    mark(value);
+  }
+  list.insert(ticket);
+}
+// remove (rebuilds the filter once removed values outnumber live ones and
+// pay for clearing its words)
+template <typename T>
+void ForkValueIndex<T>::remove(const T &value, const long long &ticket) {
+  Tickets *list = tickets.find(value);
+  if (list == nullptr) {
+    return;
+  }
+  list->erase(ticket);
+  if (list->count() > 0) {
+    return;
+  }
+  tickets.erase(value);
+  if (bloom_mask == 0 ||
+      ++removed <= std::max(tickets.get_size(), (bloom_mask >> 6) + 1)) {
+    return;
+  }
+  bloom.ResetAll(false);
+  for (auto it = tickets.begin(); it != tickets.end(); ++it) {
+    mark(it.key());
+  }
+  removed = 0;
+}
+
+// constructor (the filter size is rounded up to a power of two)
+template <typename T>
+ForkValueIndex<T>::ForkValueIndex(const int &bloom_bits) {
+  if (bloom_bits > 0) {
+    int bits = 64;
+    while (bits < bloom_bits && bits < (1 << 30)) {
+      bits *= 2;
+    }
+    bloom      = ForkBitset(bits);
+    bloom_mask = bits - 1;
+  }
+}
+
+// push_back
+template <typename T>
+void ForkValueIndex<T>::push_back(const T &value) {
+  add(value, back++);
+}
+// push_front
+template <typename T>
+void ForkValueIndex<T>::push_front(const T &value) {
+  add(value, --front);
+}
+// pop_back
+template <typename T>
+void ForkValueIndex<T>::pop_back(const T &value) {
+  remove(value, --back);
+}
+// pop_front
+template <typename T>
+void ForkValueIndex<T>::pop_front(const T &value) {
+  remove(value, front++);
+}
+// replace (the element at position changes from old_value to value)
+template <typename T>
+void ForkValueIndex<T>::replace(const int &position, const T &old_value,
+                                const T &value) {
+  if (old_value == value) {
+    return;
+  }
+  remove(old_value, front + position);
+  add(value, front + position);
+}
+// clear all
+template <typename T>
+void ForkValueIndex<T>::clear() {
+  tickets.clear();
+  if (bloom_mask != 0) {
+    bloom.ResetAll(false);
+  }
+  removed = 0;
+  front   = 0;
+  back    = 0;
+}
+// first
+template <typename T>
+int ForkValueIndex<T>::first(const T &value) const {
+  if (!maybe_contains(value)) {
+    return -1;
+  }
+  const Tickets *list = tickets.find(value);
+  return list == nullptr ? -1 : static_cast<int>(list->least() - front);
+}
+// count
+template <typename T>
+int ForkValueIndex<T>::count(const T &value) const {
+  if (!maybe_contains(value)) {
+    return 0;
+  }
+  const Tickets *list = tickets.find(value);
+  return list == nullptr ? 0 : list->count();
+}
+// contains
+template <typename T>
+bool ForkValueIndex<T>::contains(const T &value) const {
+  return first(value) >= 0;
+}
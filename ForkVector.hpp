@@ -1,116 +1,184 @@
-﻿// #pragma once
+﻿#pragma once
 
+#include <array>
 #include <iostream>
 #include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ForkBitset.hpp"  // ForkVector<bool>
+#include "ForkExport.hpp"
+#include "ForkStats.hpp"
+#include "ForkStorage.hpp"  // storage policies, ForkVector<T, Storage>
 using namespace std;
 
 template <typename T>
+class ForkValueIndex;  // ForkValueIndex.hpp, included at the end
+
+template <typename T, typename Storage>
 class ForkVector {
 public:
+  using value_type = T;
   static int init_capacity_num;  // initial capacity of the vector (default = 1)
 
 private:
-  T *data      = nullptr;            // pointer to the data
-  int size     = 0;                  // num of effective elements => effective
-  int capacity = init_capacity_num;  // num of allocated elements => allocated
-  int current  = 0;                  // current position
+  using stats = ForkStatsOf<ForkVector>;  // no-op unless FORK_STL_STATS
+
+  T *data      = nullptr;  // pointer to the data
+  int size     = 0;        // num of effective elements => effective
+  int capacity = 0;        // num of allocated elements => allocated
+  int current  = 0;        // current position
+
+  ForkValueIndex<T> *value_index = nullptr;  // off unless EnableIndex()
 
 public:
-  ForkVector();                             // constructor
-  ~ForkVector();                            // destructor
-  ForkVector(const ForkVector &other);      // copy constructor
-  ForkVector(ForkVector &&other) noexcept;  // move constructor
+  // the core below is constexpr, so a table can be built at compile time
+  // (C++20 transient allocation) and copied out with fork_static_array
+  constexpr ForkVector();                             // constructor
+  constexpr ~ForkVector();                            // destructor
+  constexpr ForkVector(const ForkVector &other);      // copy constructor
+  constexpr ForkVector(ForkVector &&other) noexcept;  // move constructor
 
   static void set_initial_capacity(const int &num);  // set init_capacity_num
 
-  void preAlloc(const int &n);                        // pre_allocate_capacity
-  void push_back(const T &value);                     // push_back
-  void pop_back();                                    // pop_back
-  void clear(const int &index);                       // clear [data_only]
-  void clear();                                       // clear [data_only]
-  void erase(const int &index);                       // erase [data & capacity]
-  void erase();                                       // erase [data & capacity]
-  void shrink_to_fit();                               // shrink_to_fit
-  [[nodiscard]] int GetSize() const;                  // get_size
-  [[nodiscard]] int GetCapacity() const;              // get_capacity
-  T *GetPtr() const;                                  // get the original ptr
-  T &GetElement(const int &index);                    // get_element
-  void SetElement(const int &index, const T &value);  // set_element
-  int GetIndex(const T &value) const;                 // get_index
-  void ResetAll(const T &value);                      // reset all elements
+  constexpr void preAlloc(const int &n);          // pre_allocate_capacity
+  constexpr void resize(const int &n);            // new elements are T()
+  constexpr void push_back(const T &value);       // push_back
+  constexpr void pop_back();                      // pop_back
+  constexpr void clear(const int &index);         // clear [data_only]
+  constexpr void clear();                         // clear [data_only]
+  constexpr void erase(const int &index);         // erase [data & capacity]
+  constexpr void erase();                         // erase [data & capacity]
+  constexpr void shrink_to_fit();                 // shrink_to_fit
+  [[nodiscard]] constexpr int GetSize() const;      // get_size
+  [[nodiscard]] constexpr int GetCapacity() const;  // get_capacity
+  constexpr T *GetPtr() const;                      // get the original ptr
+  constexpr T &GetElement(const int &index);        // get_element
+  constexpr void SetElement(const int &index, const T &value);  // set_element
+  constexpr int GetIndex(const T &value) const;                 // get_index
+  constexpr void ResetAll(const T &value);  // reset all elements
+
+  // opt-in value index, GetIndex becomes a hash probe (ForkValueIndex.hpp)
+  void EnableIndex(const int &bloom_bits = 0);  // bloom_bits 0: no filter
+  void DisableIndex();
+  void RebuildIndex();  // after writes through operator[] / GetPtr
+  [[nodiscard]] bool IsIndexed() const;
 
-  T &operator[](const int &index);                     // operator []
-  ForkVector &operator=(const ForkVector &other);      // copy assignment
-  ForkVector &operator=(ForkVector &&other) noexcept;  // move assignment
-  bool operator==(const ForkVector &other) const;
-  bool operator!=(const ForkVector &other) const;
+  constexpr T &operator[](const int &index);  // operator []
+  constexpr ForkVector &operator=(const ForkVector &other);  // copy assignment
+  constexpr ForkVector &operator=(ForkVector &&other) noexcept;  // move
+  constexpr bool operator==(const ForkVector &other) const;
+  constexpr bool operator!=(const ForkVector &other) const;
 
-  void echo() const;  // print the vector
+  void echo() const;                      // print the vector
+  void export_to(ForkExport &out) const;  // append as one record
 };
 // init_capacity_num
-template <typename T>
-int ForkVector<T>::init_capacity_num = 1;
+template <typename T, typename Storage>
+int ForkVector<T, Storage>::init_capacity_num = 1;
 
 // set_initial_capacity
-template <typename T>
-void ForkVector<T>::set_initial_capacity(const int &num) {
+template <typename T, typename Storage>
+void ForkVector<T, Storage>::set_initial_capacity(const int &num) {
   init_capacity_num = num;
 }
 
 // constructor
-template <typename T>
-ForkVector<T>::ForkVector() {
-  data = new T[capacity];
+template <typename T, typename Storage>
+constexpr ForkVector<T, Storage>::ForkVector() {
+  // init_capacity_num is runtime state, constant evaluation starts at 1
+  capacity = std::is_constant_evaluated() ? 1 : init_capacity_num;
+  data     = Storage::template allocate<T>(capacity);
+  stats::allocate(capacity * sizeof(T));
+  stats::shape(size, capacity);
 }
 // destructor
-template <typename T>
-ForkVector<T>::~ForkVector() {
-  delete[] data;
+template <typename T, typename Storage>
+constexpr ForkVector<T, Storage>::~ForkVector() {
+  if (data != nullptr) {
+    stats::release(capacity * sizeof(T));
+    stats::elements(-size);
+  }
+  Storage::deallocate(data, capacity);
+  if (value_index != nullptr) {
+    delete value_index;
+  }
 }
 // move constructor
-template <typename T>
-ForkVector<T>::ForkVector(ForkVector &&other) noexcept {
-  data           = other.data;
-  size           = other.size;
-  capacity       = other.capacity;
-  other.data     = nullptr;
-  other.size     = 0;
-  other.capacity = 0;
+template <typename T, typename Storage>
+constexpr ForkVector<T, Storage>::ForkVector(ForkVector &&other) noexcept {
+  data              = other.data;
+  size              = other.size;
+  capacity          = other.capacity;
+  value_index       = other.value_index;
+  other.data        = nullptr;
+  other.size        = 0;
+  other.capacity    = 0;
+  other.value_index = nullptr;
 }
 // copy constructor
-template <typename T>
-ForkVector<T>::ForkVector(const ForkVector &other) {
-  if (other.capacity > capacity) {
-    capacity = other.capacity;
-    data     = new T[capacity];
+template <typename T, typename Storage>
+constexpr ForkVector<T, Storage>::ForkVector(const ForkVector &other) {
+  capacity = other.capacity;
+  size     = other.size;
+  data     = Storage::template allocate<T>(capacity);
+  for (int i = 0; i < size; i++) {
+    data[i] = other.data[i];
+  }
+  stats::allocate(capacity * sizeof(T));
+  stats::elements(size);
+  stats::shape(size, capacity);
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
   }
 }
 
 // pre_allocate_capacity
-template <typename T>
-void ForkVector<T>::preAlloc(const int &n) {
-  int input = n;
-  if (input < size) {
-    std::cout << "Input Capacity {" << n << "} is smaller than original size {"
-              << size << "}, but has been automatically reset to that "
-              << "in order to avoid discarding data." << std::endl;
-    input = size;
-  }
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::preAlloc(const int &n) {
+  int input = n < size ? size : n;  // never discard data
   if (input > capacity) {
-    capacity = input;
-    T *temp  = new T[capacity];
+    stats::reallocate(capacity * sizeof(T), input * sizeof(T),
+                      size * sizeof(T));
+    T *temp = Storage::template allocate<T>(input);
     for (int i = 0; i < size; i++) {
       temp[i] = data[i];
     }
-    delete[] data;
-    data = temp;
+    Storage::deallocate(data, capacity);
+    capacity = input;
+    data     = temp;
+    stats::shape(size, capacity);
+  }
+}
+// resize
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::resize(const int &n) {
+  if (n < 0) {
+    throw std::out_of_range("index out of range");
+  }
+  if (n > capacity) {
+    preAlloc(n);
+  }
+  for (int i = size; i < n; i++) {
+    data[i] = T();
   }
+  if (value_index != nullptr) {
+    for (int i = size - 1; i >= n; i--) {
+      value_index->pop_back(data[i]);
+    }
+    for (int i = size; i < n; i++) {
+      value_index->push_back(data[i]);
+    }
+  }
+  stats::elements(n - size);
+  size = n;
+  stats::shape(size, capacity);
 }
 // push_back
-template <typename T>
-void ForkVector<T>::push_back(const T &value) {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::push_back(const T &value) {
   if (size == capacity) {
-    preAlloc(capacity * 2);
+    preAlloc(capacity > 0 ? capacity * 2 : 1);
     // preAlloc(capacity * 2) is more likely to be efficient
     // than preAlloc(capacity + 1)
     //
@@ -123,46 +191,57 @@ void ForkVector<T>::push_back(const T &value) {
     // after push_back n times
   }
   data[size] = value;
+  if (value_index != nullptr) {
+    value_index->push_back(data[size]);
+  }
   ++size;
+  stats::elements(1);
+  stats::shape(size, capacity);
 }
 // pop_back
-template <typename T>
-void ForkVector<T>::pop_back() {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::pop_back() {
   if (size > 0) {
+    if (value_index != nullptr) {
+      value_index->pop_back(data[size - 1]);
+    }
     --size;
+    stats::elements(-1);
   }
 }
 // shrink_to_fit
-template <typename T>
-void ForkVector<T>::shrink_to_fit() {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::shrink_to_fit() {
   if (size < capacity) {
-    capacity = size;
-    T *temp  = new T[capacity];
+    stats::reallocate(capacity * sizeof(T), size * sizeof(T),
+                      size * sizeof(T));
+    T *temp = Storage::template allocate<T>(size);
     for (int i = 0; i < size; i++) {
       temp[i] = data[i];
     }
-    delete[] data;
-    data = temp;
+    Storage::deallocate(data, capacity);
+    capacity = size;
+    data     = temp;
   }
 }
 // get_size
-template <typename T>
-int ForkVector<T>::GetSize() const {
+template <typename T, typename Storage>
+constexpr int ForkVector<T, Storage>::GetSize() const {
   return size;
 }
 // get_capacity
-template <typename T>
-int ForkVector<T>::GetCapacity() const {
+template <typename T, typename Storage>
+constexpr int ForkVector<T, Storage>::GetCapacity() const {
   return capacity;
 }
 // get the original ptr
-template <typename T>
-T *ForkVector<T>::GetPtr() const {
+template <typename T, typename Storage>
+constexpr T *ForkVector<T, Storage>::GetPtr() const {
   return data;
 }
 // clear [index]
-template <typename T>
-void ForkVector<T>::clear(const int &index) {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::clear(const int &index) {
   if (index < 0 || index >= size) {
     return;
   }
@@ -170,15 +249,23 @@ void ForkVector<T>::clear(const int &index) {
     data[i] = data[i + 1];
   }
   --size;
+  stats::elements(-1);
+  if (value_index != nullptr) {
+    RebuildIndex();  // every later position moved
+  }
 }
 // clear all
-template <typename T>
-void ForkVector<T>::clear() {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::clear() {
+  stats::elements(-size);
   size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
 }
 // erase [index]
-template <typename T>
-void ForkVector<T>::erase(const int &index) {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::erase(const int &index) {
   if (index < 0 || index >= size) {
     return;
   }
@@ -186,91 +273,162 @@ void ForkVector<T>::erase(const int &index) {
     data[i] = data[i + 1];
   }
   --size;
+  stats::elements(-1);
+  if (value_index != nullptr) {
+    RebuildIndex();  // every later position moved
+  }
   shrink_to_fit();
 }
 // erase all
-template <typename T>
-void ForkVector<T>::erase() {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::erase() {
+  stats::elements(-size);
   size = 0;
+  if (value_index != nullptr) {
+    value_index->clear();
+  }
   shrink_to_fit();
 }
 // get_element
-template <typename T>
-T &ForkVector<T>::GetElement(const int &index) {
+template <typename T, typename Storage>
+constexpr T &ForkVector<T, Storage>::GetElement(const int &index) {
   if (index < 0 || index >= size) {
     throw std::out_of_range("index out of range");  // throw exception
   }
   return data[index];
 }
 // set_element
-template <typename T>
-void ForkVector<T>::SetElement(const int &index, const T &value) {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::SetElement(const int &index,
+                                                  const T &value) {
   if (index < 0 || index >= size) {
     throw std::out_of_range("index out of range");  // throw exception
   }
+  if (value_index != nullptr) {
+    value_index->replace(index, data[index], value);
+  }
   data[index] = value;
 }
 // get_index
-template <typename T>
-int ForkVector<T>::GetIndex(const T &value) const {
-  bool if_found = false;
+template <typename T, typename Storage>
+constexpr int ForkVector<T, Storage>::GetIndex(const T &value) const {
+  if (value_index != nullptr) {
+    return value_index->first(value);
+  }
   for (int i = 0; i < size; i++) {
     if (data[i] == value) {
-      if_found = true;
+      stats::walk(i + 1);
       return i;
     }
   }
+  stats::walk(size);
   return -1;
 }
 // ResetAll (with parameter)
-template <typename T>
-void ForkVector<T>::ResetAll(const T &value) {
+template <typename T, typename Storage>
+constexpr void ForkVector<T, Storage>::ResetAll(const T &value) {
   for (int i = 0; i < size; i++) {
     data[i] = value;
   }
+  if (value_index != nullptr) {
+    RebuildIndex();
+  }
+}
+// enable_index
+template <typename T, typename Storage>
+void ForkVector<T, Storage>::EnableIndex(const int &bloom_bits) {
+  delete value_index;
+  value_index = new ForkValueIndex<T>(bloom_bits);
+  RebuildIndex();
+}
+// disable_index
+template <typename T, typename Storage>
+void ForkVector<T, Storage>::DisableIndex() {
+  delete value_index;
+  value_index = nullptr;
+}
+// rebuild_index
+template <typename T, typename Storage>
+void ForkVector<T, Storage>::RebuildIndex() {
+  if (value_index == nullptr) {
+    return;
+  }
+  value_index->clear();
+  for (int i = 0; i < size; i++) {
+    value_index->push_back(data[i]);
+  }
+}
+// is_indexed
+template <typename T, typename Storage>
+bool ForkVector<T, Storage>::IsIndexed() const {
+  return value_index != nullptr;
 }
 
 // operator []
-template <typename T>
-T &ForkVector<T>::operator[](const int &index) {
+template <typename T, typename Storage>
+constexpr T &ForkVector<T, Storage>::operator[](const int &index) {
   if (index < 0 || index >= size) {
     throw std::out_of_range("index out of range");  // throw exception
   }
   return data[index];
 }
 // copy assignment
-template <typename T>
-ForkVector<T> &ForkVector<T>::operator=(const ForkVector &other) {
+template <typename T, typename Storage>
+constexpr ForkVector<T, Storage> &ForkVector<T, Storage>::operator=(
+    const ForkVector &other) {
   if (this == &other) {
     return *this;
   }
-  if (other.capacity > capacity) {
+  if (other.size > capacity) {
+    stats::reallocate(capacity * sizeof(T), other.capacity * sizeof(T), 0);
+    Storage::deallocate(data, capacity);
     capacity = other.capacity;
-    data     = new T[capacity];
+    data     = Storage::template allocate<T>(capacity);
   }
+  stats::elements(other.size - size);
+  stats::shape(other.size, capacity);
   size = other.size;
   for (int i = 0; i < size; i++) {
     data[i] = other.data[i];
   }
+  if (value_index != nullptr) {  // the index follows the contents
+    delete value_index;
+    value_index = nullptr;
+  }
+  if (other.value_index != nullptr) {
+    value_index = new ForkValueIndex<T>(*other.value_index);
+  }
   return *this;
 }
 // move assignment
-template <typename T>
-ForkVector<T> &ForkVector<T>::operator=(ForkVector &&other) noexcept {
+template <typename T, typename Storage>
+constexpr ForkVector<T, Storage> &ForkVector<T, Storage>::operator=(
+    ForkVector &&other) noexcept {
   if (this == &other) {
     return *this;
   }
-  data           = other.data;
-  size           = other.size;
-  capacity       = other.capacity;
-  other.data     = nullptr;
-  other.size     = 0;
-  other.capacity = 0;
+  if (data != nullptr) {
+    stats::release(capacity * sizeof(T));
+    stats::elements(-size);
+  }
+  Storage::deallocate(data, capacity);
+  if (value_index != nullptr) {
+    delete value_index;
+  }
+  data              = other.data;
+  size              = other.size;
+  capacity          = other.capacity;
+  value_index       = other.value_index;
+  other.data        = nullptr;
+  other.size        = 0;
+  other.capacity    = 0;
+  other.value_index = nullptr;
   return *this;
 }
 // operator ==
-template <typename T>
-bool ForkVector<T>::operator==(const ForkVector &other) const {
+template <typename T, typename Storage>
+constexpr bool ForkVector<T, Storage>::operator==(
+    const ForkVector &other) const {
   if (size != other.size) {
     return false;
   }
@@ -282,8 +440,9 @@ bool ForkVector<T>::operator==(const ForkVector &other) const {
   return true;
 }
 // operator !=
-template <typename T>
-bool ForkVector<T>::operator!=(const ForkVector &other) const {
+template <typename T, typename Storage>
+constexpr bool ForkVector<T, Storage>::operator!=(
+    const ForkVector &other) const {
   if (size != other.size) {
     return true;
   }
@@ -296,8 +455,8 @@ bool ForkVector<T>::operator!=(const ForkVector &other) const {
 }
 
 // echo
-template <typename T>
-void ForkVector<T>::echo() const {
+template <typename T, typename Storage>
+void ForkVector<T, Storage>::echo() const {
   cout << "current vector: ";
   for (int i = 0; i < size; i++) {
     cout << data[i] << ", ";
@@ -305,3 +464,36 @@ void ForkVector<T>::echo() const {
   cout << "\b\b  \b\b" << endl;
   cout << endl;
 }
+// export_to
+template <typename T, typename Storage>
+void ForkVector<T, Storage>::export_to(ForkExport &out) const {
+  for (int i = 0; i < size; i++) {
+    out.add(data[i]);
+  }
+  out.end_record();
+}
+
+// fork_static_array
+// runs make() at compile time and copies the ForkVector it returns into a
+// std::array, so the table lives in read-only data instead of being built
+// at startup:
+//   constexpr auto squares = fork_static_array<[] {
+//     ForkVector<int> table;
+//     for (int i = 0; i < 16; i++) {
+//       table.push_back(i * i);
+//     }
+//     return table;
+//   }>();
+template <auto make>
+consteval auto fork_static_array() {
+  using T         = typename decltype(make())::value_type;
+  constexpr int n = make().GetSize();
+  std::array<T, n> table{};
+  auto built = make();
+  for (int i = 0; i < n; i++) {
+    table[i] = built[i];
+  }
+  return table;
+}
+
+#include "ForkValueIndex.hpp"  // completes ForkValueIndex<T>
@@ -0,0 +1,336 @@
+// ForkStack / ForkQueue interfaces over a ForkVector buffer
+// the buffer is moved in and moved back out, so a batch built in a vector
+// becomes a stack or a queue (and back) in O(1), no element is copied:
+//   ForkVector<Job> batch = ...;
+//   ForkVectorQueue<Job> work(std::move(batch));  // steals the buffer
+//   Job next = work.fetch_head();                 // head: batch[0]
+//   ForkVector<Job> rest = work.release();        // hand the rest on
+//
+// ForkVectorStack keeps its surface at the back of the buffer, push and pop
+// are push_back and pop_back; ForkVectorQueue reads from an offset that
+// moves toward the back, the dead prefix is dropped once it is at least
+// half of the buffer (amortized O(1)) and on release()
+//
+// like a ForkChain handoff, the buffer's value index is not carried over,
+// call EnableIndex() on the vector that release() returns
+
+/*
+ *  ForkVectorStack  [ bottom | ... | surface ]
+ *  ForkVectorQueue  [ fetched | head | ... | tail ]
+ *                             ^ first
+ */
+
+#pragma once
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "ForkExport.hpp"
+#include "ForkVector.hpp"
+
+template <typename T, typename Storage = ForkDefaultStorage>
+class ForkVectorStack {
+public:
+  using value_type = T;
+  using buffer     = ForkVector<T, Storage>;
+
+private:
+  buffer items;  // bottom at 0, surface at the back
+
+public:
+  // constructor and destructor
+  ForkVectorStack() = default;
+  explicit ForkVectorStack(buffer &&from);  // steals the buffer, O(1)
+
+  // functions
+  void push(const T &data);       // push a value into the stack
+  [[nodiscard]] T pop();          // remove the surface then return value
+  void pop_without_return();      // remove the surface
+  [[nodiscard]] T &return_top();  // show the top of the stack
+  void clear();
+  [[nodiscard]] T &get_element(const int &index);  // index from the surface
+  [[nodiscard]] int get_index(const T &value) const;  // from the surface
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] bool is_empty() const;
+  buffer release();  // give the buffer back, bottom first, O(1)
+
+  // echo and export (surface to bottom)
+  void echo() const;
+  void export_to(ForkExport &out) const;
+};
+
+template <typename T, typename Storage = ForkDefaultStorage>
+class ForkVectorQueue {
+public:
+  using value_type = T;
+  using buffer     = ForkVector<T, Storage>;
+
+private:
+  static constexpr int compact_after = 32;  // smallest prefix worth moving
+
+  buffer items;   // fetched prefix, then head .. tail
+  int first = 0;  // position of the head in items
+
+  void compact();  // drop the fetched prefix
+
+public:
+  // constructor and destructor
+  ForkVectorQueue() = default;
+  explicit ForkVectorQueue(buffer &&from);  // steals the buffer, O(1)
+
+  // functions
+  void push(const T &data);  // push a value at the tail
+  void quit_head();          // drop the head
+  void quit_tail();          // drop the tail
+  T fetch_head();            // remove the head then return value
+  T fetch_tail();            // remove the tail then return value
+  void clear();
+  T &get_element(const int &index);  // index counted from head
+  [[nodiscard]] int get_index(const T &value) const;
+  [[nodiscard]] int get_size() const;
+  [[nodiscard]] bool is_empty() const;
+  buffer release();  // give the buffer back, head first, O(n) at most once
+
+  // echo and export (head to tail)
+  void echo() const;
+  void export_to(ForkExport &out) const;
+};
+
+// ForkVectorStack
+
+// constructor
+template <typename T, typename Storage>
+ForkVectorStack<T, Storage>::ForkVectorStack(buffer &&from)
+    : items(std::move(from)) {
+  items.DisableIndex();
+}
+
+// push
+template <typename T, typename Storage>
+void ForkVectorStack<T, Storage>::push(const T &data) {
+  items.push_back(data);
+}
+// pop
+template <typename T, typename Storage>
+T ForkVectorStack<T, Storage>::pop() {
+  if (items.GetSize() == 0) {
+    throw std::out_of_range("stack is empty");
+  }
+  T data = std::move(items.GetPtr()[items.GetSize() - 1]);
+  items.pop_back();
+  return data;
+}
+// pop_without_return
+template <typename T, typename Storage>
+void ForkVectorStack<T, Storage>::pop_without_return() {
+  if (items.GetSize() == 0) {
+    throw std::out_of_range("stack is empty");
+  }
+  items.pop_back();
+}
+// return_top
+template <typename T, typename Storage>
+T &ForkVectorStack<T, Storage>::return_top() {
+  if (items.GetSize() == 0) {
+    throw std::out_of_range("stack is empty");
+  }
+  return items.GetPtr()[items.GetSize() - 1];
+}
+// clear
+template <typename T, typename Storage>
+void ForkVectorStack<T, Storage>::clear() {
+  items.clear();
+}
+// get_element
+template <typename T, typename Storage>
+T &ForkVectorStack<T, Storage>::get_element(const int &index) {
+  if (index < 0 || index >= items.GetSize()) {
+    throw std::out_of_range("index out of range");
+  }
+  return items.GetPtr()[items.GetSize() - 1 - index];
+}
+// get_index
+template <typename T, typename Storage>
+int ForkVectorStack<T, Storage>::get_index(const T &value) const {
+  const T *data = items.GetPtr();
+  for (int i = items.GetSize() - 1; i >= 0; i--) {
+    if (data[i] == value) {
+      return items.GetSize() - 1 - i;
+    }
+  }
+  return -1;
+}
+// get_size
+template <typename T, typename Storage>
+int ForkVectorStack<T, Storage>::get_size() const {
+  return items.GetSize();
+}
+// is_empty
+template <typename T, typename Storage>
+bool ForkVectorStack<T, Storage>::is_empty() const {
+  return items.GetSize() == 0;
+}
+// release
+template <typename T, typename Storage>
+typename ForkVectorStack<T, Storage>::buffer
+ForkVectorStack<T, Storage>::release() {
+  return std::move(items);
+}
+// echo
+template <typename T, typename Storage>
+void ForkVectorStack<T, Storage>::echo() const {
+  std::cout << "current stack: ";
+  const T *data = items.GetPtr();
+  for (int i = items.GetSize() - 1; i >= 0; i--) {
+    std::cout << data[i] << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+// export_to
+template <typename T, typename Storage>
+void ForkVectorStack<T, Storage>::export_to(ForkExport &out) const {
+  const T *data = items.GetPtr();
+  for (int i = items.GetSize() - 1; i >= 0; i--) {
+    out.add(data[i]);
+  }
+  out.end_record();
+}
+
+// ForkVectorQueue
+
+// compact
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::compact() {
+  T *data = items.GetPtr();
+  int n   = items.GetSize() - first;
+  for (int i = 0; i < n; i++) {
+    data[i] = std::move(data[first + i]);
+  }
+  items.resize(n);
+  first = 0;
+}
+
+// constructor
+template <typename T, typename Storage>
+ForkVectorQueue<T, Storage>::ForkVectorQueue(buffer &&from)
+    : items(std::move(from)) {
+  items.DisableIndex();
+}
+
+// push
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::push(const T &data) {
+  items.push_back(data);
+}
+// quit_head
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::quit_head() {
+  if (first == items.GetSize()) {
+    return;
+  }
+  ++first;
+  if (first == items.GetSize()) {
+    items.clear();  // drained, reuse the buffer from the start
+    first = 0;
+  } else if (first >= compact_after && first * 2 >= items.GetSize()) {
+    compact();
+  }
+}
+// quit_tail
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::quit_tail() {
+  if (first == items.GetSize()) {
+    return;
+  }
+  items.pop_back();
+  if (first == items.GetSize()) {
+    items.clear();
+    first = 0;
+  }
+}
+// fetch_head
+template <typename T, typename Storage>
+T ForkVectorQueue<T, Storage>::fetch_head() {
+  if (first == items.GetSize()) {
+    throw std::out_of_range("queue is empty");
+  }
+  T data = std::move(items.GetPtr()[first]);
+  quit_head();
+  return data;
+}
+// fetch_tail
+template <typename T, typename Storage>
+T ForkVectorQueue<T, Storage>::fetch_tail() {
+  if (first == items.GetSize()) {
+    throw std::out_of_range("queue is empty");
+  }
+  T data = std::move(items.GetPtr()[items.GetSize() - 1]);
+  quit_tail();
+  return data;
+}
+// clear
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::clear() {
+  items.clear();
+  first = 0;
+}
+// get_element
+template <typename T, typename Storage>
+T &ForkVectorQueue<T, Storage>::get_element(const int &index) {
+  if (index < 0 || index >= items.GetSize() - first) {
+    throw std::out_of_range("index out of range");
+  }
+  return items.GetPtr()[first + index];
+}
+// get_index
+template <typename T, typename Storage>
+int ForkVectorQueue<T, Storage>::get_index(const T &value) const {
+  const T *data = items.GetPtr();
+  for (int i = first; i < items.GetSize(); i++) {
+    if (data[i] == value) {
+      return i - first;
+    }
+  }
+  return -1;
+}
+// get_size
+template <typename T, typename Storage>
+int ForkVectorQueue<T, Storage>::get_size() const {
+  return items.GetSize() - first;
+}
+// is_empty
+template <typename T, typename Storage>
+bool ForkVectorQueue<T, Storage>::is_empty() const {
+  return first == items.GetSize();
+}
+// release
+template <typename T, typename Storage>
+typename ForkVectorQueue<T, Storage>::buffer
+ForkVectorQueue<T, Storage>::release() {
+  if (first > 0) {
+    compact();
+  }
+  return std::move(items);
+}
+// echo
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::echo() const {
+  std::cout << "current queue: ";
+  const T *data = items.GetPtr();
+  for (int i = first; i < items.GetSize(); i++) {
+    std::cout << data[i] << ", ";
+  }
+  std::cout << "\b\b  \b\b" << std::endl;
+  std::cout << std::endl;
+}
+// export_to
+template <typename T, typename Storage>
+void ForkVectorQueue<T, Storage>::export_to(ForkExport &out) const {
+  const T *data = items.GetPtr();
+  for (int i = first; i < items.GetSize(); i++) {
+    out.add(data[i]);
+  }
+  out.end_record();
+}
@@ -0,0 +1,1431 @@
+// ForkSTL_bench: Fork containers against their standard library counterparts
+// usage: ForkSTL_bench [--quick] [--reps N] [--perf] [--scan-mb MB] [filter]
+// prints CSV on stdout (see ForkBench.hpp), diff two runs between releases
+// --perf adds per-op hardware counters (cycles, cache / TLB / branch misses)
+// --scan-mb adds a huge_page_vector run over a buffer of that many MiB
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <stack>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ForkBTreeMap.hpp"
+#include "ForkBench.hpp"
+#include "ForkConcurrentVector.hpp"
+#include "ForkDeque.hpp"
+#include "ForkFlatMap.hpp"
+#include "ForkGapBuffer.hpp"
+#include "ForkHashMap.hpp"
+#include "ForkList.hpp"
+#include "ForkPackedVector.hpp"
+#include "ForkPersistentVector.hpp"
+#include "ForkPriorityQueue.hpp"
+#include "ForkQueue.hpp"
+#include "ForkSlotMap.hpp"
+#include "ForkSoAVector.hpp"
+#include "ForkStack.hpp"
+#include "ForkVector.hpp"
+#include "ForkVectorAdaptor.hpp"
+
+// element types: a register-sized one and one that owns heap memory
+template <typename T>
+class Element;
+template <>
+class Element<int> {
+public:
+  static const char *name() { return "int"; }
+  static int make(const int &i) { return i; }
+};
+template <>
+class Element<std::string> {
+public:
+  static const char *name() { return "string"; }
+  // longer than any small-string buffer, so every copy allocates
+  static std::string make(const int &i) {
+    return "fork-stl-bench-value-" + std::to_string(i);
+  }
+};
+
+// inputs shared by every benchmark of one (element, n) pair
+template <typename T>
+class Inputs {
+public:
+  int n       = 0;
+  int queries = 0;              // num of O(n) lookups per repetition
+  std::vector<T> values;        // values[i] = Element<T>::make(i)
+  std::vector<int> random_idx;  // n uniformly random indices in [0, n)
+  std::vector<T> probes;        // queries values, all present
+  Inputs(const int &n, const unsigned &seed) : n(n) {
+    queries = n < 256 ? n : 256;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    values.reserve(n);
+    random_idx.reserve(n);
+    for (int i = 0; i < n; i++) {
+      values.push_back(Element<T>::make(i));
+      random_idx.push_back(pick(rng));
+    }
+    for (int i = 0; i < queries; i++) {
+      probes.push_back(values[pick(rng)]);
+    }
+  }
+};
+
+template <typename T>
+void BenchVector(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int q   = in.queries;
+  ForkVector<T> fork_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(in.values[i]);
+  }
+  std::vector<T> std_filled(in.values);
+  auto fork_empty = [] { return ForkVector<T>(); };
+  auto std_empty  = [] { return std::vector<T>(); };
+  auto fork_copy  = [&] { return ForkVector<T>(fork_filled); };
+  auto std_copy   = [&] { return std::vector<T>(std_filled); };
+
+  bench.run("fork", "vector", "push_back", e, n, n, fork_empty,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("std", "vector", "push_back", e, n, n, std_empty,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("fork", "vector", "push_back_prealloc", e, n, n, fork_empty,
+            [&](ForkVector<T> &v) {
+              v.preAlloc(n);
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("std", "vector", "push_back_prealloc", e, n, n, std_empty,
+            [&](std::vector<T> &v) {
+              v.reserve(n);
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("fork", "vector", "pop_back", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) v.pop_back();
+            });
+  bench.run("std", "vector", "pop_back", e, n, n, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) v.pop_back();
+            });
+  bench.run("fork", "vector", "random_access", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+  bench.run("std", "vector", "random_access", e, n, n, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+  bench.run("fork", "vector", "set_element", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) {
+                v.SetElement(in.random_idx[i], in.values[i]);
+              }
+            });
+  bench.run("std", "vector", "set_element", e, n, n, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) v.at(in.random_idx[i]) = in.values[i];
+            });
+  bench.run("fork", "vector", "search", e, n, q, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(v.GetIndex(in.probes[i]));
+              }
+            });
+  bench.run("std", "vector", "search", e, n, q, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(std::find(v.begin(), v.end(), in.probes[i]));
+              }
+            });
+  bench.run("fork", "vector", "erase_middle", e, n, q, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < q; i++) v.clear(v.GetSize() / 2);
+            });
+  bench.run("std", "vector", "erase_middle", e, n, q, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < q; i++) v.erase(v.begin() + v.size() / 2);
+            });
+  bench.run("fork", "vector", "copy_construct", e, n, n, fork_empty,
+            [&](ForkVector<T> &v) { v = ForkVector<T>(fork_filled); });
+  bench.run("std", "vector", "copy_construct", e, n, n, std_empty,
+            [&](std::vector<T> &v) { v = std::vector<T>(std_filled); });
+  bench.run("fork", "vector", "copy_assign", e, n, n, fork_empty,
+            [&](ForkVector<T> &v) { v = fork_filled; });
+  bench.run("std", "vector", "copy_assign", e, n, n, std_empty,
+            [&](std::vector<T> &v) { v = std_filled; });
+  bench.run("fork", "vector", "move_construct", e, n, 1, fork_copy,
+            [&](ForkVector<T> &v) {
+              ForkVector<T> moved(std::move(v));
+              ForkBench::keep(moved);
+            });
+  bench.run("std", "vector", "move_construct", e, n, 1, std_copy,
+            [&](std::vector<T> &v) {
+              std::vector<T> moved(std::move(v));
+              ForkBench::keep(moved);
+            });
+  bench.run("fork", "vector", "reset_all", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) { v.ResetAll(in.values[0]); });
+  bench.run("std", "vector", "reset_all", e, n, n, std_copy,
+            [&](std::vector<T> &v) {
+              std::fill(v.begin(), v.end(), in.values[0]);
+            });
+  bench.run("fork", "vector", "equality", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) { ForkBench::keep(v == fork_filled); });
+  bench.run("std", "vector", "equality", e, n, n, std_copy,
+            [&](std::vector<T> &v) { ForkBench::keep(v == std_filled); });
+  bench.run("fork", "vector", "shrink_to_fit", e, n, n,
+            [&] {
+              ForkVector<T> v(fork_filled);
+              v.preAlloc(2 * n);
+              return v;
+            },
+            [&](ForkVector<T> &v) { v.shrink_to_fit(); });
+  bench.run("std", "vector", "shrink_to_fit", e, n, n,
+            [&] {
+              std::vector<T> v(std_filled);
+              v.reserve(2 * n);
+              return v;
+            },
+            [&](std::vector<T> &v) { v.shrink_to_fit(); });
+}
+
+template <typename T>
+void BenchList(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int q   = in.queries;
+  ForkList<T> fork_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(in.values[i]);
+  }
+  std::list<T> std_filled(in.values.begin(), in.values.end());
+  auto fork_empty = [] { return ForkList<T>(); };
+  auto std_empty  = [] { return std::list<T>(); };
+  auto fork_copy  = [&] { return ForkList<T>(fork_filled); };
+  auto std_copy   = [&] { return std::list<T>(std_filled); };
+
+  bench.run("fork", "list", "push_back", e, n, n, fork_empty,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < n; i++) l.push_back(in.values[i]);
+            });
+  bench.run("std", "list", "push_back", e, n, n, std_empty,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < n; i++) l.push_back(in.values[i]);
+            });
+  bench.run("fork", "list", "push_front", e, n, n, fork_empty,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < n; i++) l.push_front(in.values[i]);
+            });
+  bench.run("std", "list", "push_front", e, n, n, std_empty,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < n; i++) l.push_front(in.values[i]);
+            });
+  bench.run("fork", "list", "pop_back", e, n, n, fork_copy,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < n; i++) l.pop_back();
+            });
+  bench.run("std", "list", "pop_back", e, n, n, std_copy,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < n; i++) l.pop_back();
+            });
+  bench.run("fork", "list", "pop_front", e, n, n, fork_copy,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < n; i++) l.pop_front();
+            });
+  bench.run("std", "list", "pop_front", e, n, n, std_copy,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < n; i++) l.pop_front();
+            });
+  bench.run("fork", "list", "random_access", e, n, q, fork_copy,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < q; i++) ForkBench::keep(l[in.random_idx[i]]);
+            });
+  bench.run("std", "list", "random_access", e, n, q, std_copy,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(*std::next(l.begin(), in.random_idx[i]));
+              }
+            });
+  bench.run("fork", "list", "set_element", e, n, q, fork_copy,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < q; i++) {
+                l.SetElement(in.random_idx[i], in.values[i]);
+              }
+            });
+  bench.run("std", "list", "set_element", e, n, q, std_copy,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < q; i++) {
+                *std::next(l.begin(), in.random_idx[i]) = in.values[i];
+              }
+            });
+  bench.run("fork", "list", "search", e, n, q, fork_copy,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(l.GetIndex(in.probes[i]));
+              }
+            });
+  bench.run("std", "list", "search", e, n, q, std_copy,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(std::find(l.begin(), l.end(), in.probes[i]));
+              }
+            });
+  bench.run("fork", "list", "erase_middle", e, n, q, fork_copy,
+            [&](ForkList<T> &l) {
+              for (int i = 0; i < q; i++) l.erase(l.GetSize() / 2);
+            });
+  bench.run("std", "list", "erase_middle", e, n, q, std_copy,
+            [&](std::list<T> &l) {
+              for (int i = 0; i < q; i++) {
+                l.erase(std::next(l.begin(), l.size() / 2));
+              }
+            });
+  bench.run("fork", "list", "copy_construct", e, n, n, fork_empty,
+            [&](ForkList<T> &l) { l = ForkList<T>(fork_filled); });
+  bench.run("std", "list", "copy_construct", e, n, n, std_empty,
+            [&](std::list<T> &l) { l = std::list<T>(std_filled); });
+  bench.run("fork", "list", "copy_assign", e, n, n, fork_empty,
+            [&](ForkList<T> &l) { l = fork_filled; });
+  bench.run("std", "list", "copy_assign", e, n, n, std_empty,
+            [&](std::list<T> &l) { l = std_filled; });
+  bench.run("fork", "list", "move_construct", e, n, 1, fork_copy,
+            [&](ForkList<T> &l) {
+              ForkList<T> moved(std::move(l));
+              ForkBench::keep(moved);
+            });
+  bench.run("std", "list", "move_construct", e, n, 1, std_copy,
+            [&](std::list<T> &l) {
+              std::list<T> moved(std::move(l));
+              ForkBench::keep(moved);
+            });
+  bench.run("fork", "list", "reset_all", e, n, n, fork_copy,
+            [&](ForkList<T> &l) { l.ResetAll(in.values[0]); });
+  bench.run("std", "list", "reset_all", e, n, n, std_copy,
+            [&](std::list<T> &l) {
+              std::fill(l.begin(), l.end(), in.values[0]);
+            });
+  bench.run("fork", "list", "equality", e, n, n, fork_copy,
+            [&](ForkList<T> &l) { ForkBench::keep(l == fork_filled); });
+  bench.run("std", "list", "equality", e, n, n, std_copy,
+            [&](std::list<T> &l) { ForkBench::keep(l == std_filled); });
+}
+
+// std::stack and std::queue have no indexed access, so get_element and
+// get_index only have a fork row
+template <typename T>
+void BenchStack(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int q   = in.queries;
+  ForkStack<T> fork_filled;
+  std::stack<T> std_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push(in.values[i]);
+    std_filled.push(in.values[i]);
+  }
+  auto fork_empty = [] { return ForkStack<T>(); };
+  auto std_empty  = [] { return std::stack<T>(); };
+  auto fork_copy  = [&] { return ForkStack<T>(fork_filled); };
+  auto std_copy   = [&] { return std::stack<T>(std_filled); };
+
+  bench.run("fork", "stack", "push", e, n, n, fork_empty,
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < n; i++) s.push(in.values[i]);
+            });
+  bench.run("std", "stack", "push", e, n, n, std_empty,
+            [&](std::stack<T> &s) {
+              for (int i = 0; i < n; i++) s.push(in.values[i]);
+            });
+  bench.run("fork", "stack", "pop", e, n, n, fork_copy,
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < n; i++) s.pop_without_return();
+            });
+  bench.run("std", "stack", "pop", e, n, n, std_copy,
+            [&](std::stack<T> &s) {
+              for (int i = 0; i < n; i++) s.pop();
+            });
+  bench.run("fork", "stack", "pop_value", e, n, n, fork_copy,
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < n; i++) ForkBench::keep(s.pop());
+            });
+  bench.run("std", "stack", "pop_value", e, n, n, std_copy,
+            [&](std::stack<T> &s) {
+              for (int i = 0; i < n; i++) {
+                T value = s.top();
+                s.pop();
+                ForkBench::keep(value);
+              }
+            });
+  bench.run("fork", "stack", "top", e, n, n, fork_copy,
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < n; i++) ForkBench::keep(s.return_top());
+            });
+  bench.run("std", "stack", "top", e, n, n, std_copy,
+            [&](std::stack<T> &s) {
+              for (int i = 0; i < n; i++) ForkBench::keep(s.top());
+            });
+  bench.run("fork", "stack", "get_element", e, n, q, fork_copy,
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(s.get_element(in.random_idx[i]));
+              }
+            });
+  bench.run("fork", "stack", "search", e, n, q, fork_copy,
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(s.get_index(in.probes[i]));
+              }
+            });
+  bench.run("fork", "stack", "copy_construct", e, n, n, fork_empty,
+            [&](ForkStack<T> &s) { s = ForkStack<T>(fork_filled); });
+  bench.run("std", "stack", "copy_construct", e, n, n, std_empty,
+            [&](std::stack<T> &s) { s = std::stack<T>(std_filled); });
+  bench.run("fork", "stack", "move_construct", e, n, 1, fork_copy,
+            [&](ForkStack<T> &s) {
+              ForkStack<T> moved(std::move(s));
+              ForkBench::keep(moved);
+            });
+  bench.run("std", "stack", "move_construct", e, n, 1, std_copy,
+            [&](std::stack<T> &s) {
+              std::stack<T> moved(std::move(s));
+              ForkBench::keep(moved);
+            });
+}
+
+template <typename T>
+void BenchQueue(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int q   = in.queries;
+  ForkQueue<T> fork_filled;
+  std::queue<T> std_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push(in.values[i]);
+    std_filled.push(in.values[i]);
+  }
+  auto fork_empty = [] { return ForkQueue<T>(); };
+  auto std_empty  = [] { return std::queue<T>(); };
+  auto fork_copy  = [&] { return ForkQueue<T>(fork_filled); };
+  auto std_copy   = [&] { return std::queue<T>(std_filled); };
+
+  bench.run("fork", "queue", "push", e, n, n, fork_empty,
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) s.push(in.values[i]);
+            });
+  bench.run("std", "queue", "push", e, n, n, std_empty,
+            [&](std::queue<T> &s) {
+              for (int i = 0; i < n; i++) s.push(in.values[i]);
+            });
+  bench.run("fork", "queue", "pop", e, n, n, fork_copy,
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) s.quit_head();
+            });
+  bench.run("std", "queue", "pop", e, n, n, std_copy,
+            [&](std::queue<T> &s) {
+              for (int i = 0; i < n; i++) s.pop();
+            });
+  bench.run("fork", "queue", "pop_value", e, n, n, fork_copy,
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) ForkBench::keep(s.fetch_head());
+            });
+  bench.run("std", "queue", "pop_value", e, n, n, std_copy,
+            [&](std::queue<T> &s) {
+              for (int i = 0; i < n; i++) {
+                T value = s.front();
+                s.pop();
+                ForkBench::keep(value);
+              }
+            });
+  bench.run("fork", "queue", "pop_tail", e, n, n, fork_copy,
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) s.quit_tail();
+            });
+  bench.run("fork", "queue", "get_element", e, n, q, fork_copy,
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(s.get_element(in.random_idx[i]));
+              }
+            });
+  bench.run("fork", "queue", "search", e, n, q, fork_copy,
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(s.get_index(in.probes[i]));
+              }
+            });
+  bench.run("fork", "queue", "copy_construct", e, n, n, fork_empty,
+            [&](ForkQueue<T> &s) { s = ForkQueue<T>(fork_filled); });
+  bench.run("std", "queue", "copy_construct", e, n, n, std_empty,
+            [&](std::queue<T> &s) { s = std::queue<T>(std_filled); });
+  bench.run("fork", "queue", "move_construct", e, n, 1, fork_copy,
+            [&](ForkQueue<T> &s) {
+              ForkQueue<T> moved(std::move(s));
+              ForkBench::keep(moved);
+            });
+  bench.run("std", "queue", "move_construct", e, n, 1, std_copy,
+            [&](std::queue<T> &s) {
+              std::queue<T> moved(std::move(s));
+              ForkBench::keep(moved);
+            });
+}
+
+template <typename T>
+void BenchPriorityQueue(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  // push in random order, otherwise every push is a best or worst case
+  std::vector<T> shuffled;
+  shuffled.reserve(n);
+  for (int i = 0; i < n; i++) {
+    shuffled.push_back(in.values[in.random_idx[i]]);
+  }
+  using Fork = ForkPriorityQueue<T>;
+  using Std  = std::priority_queue<T>;
+  auto fork_filled = [&] { return Fork(shuffled.begin(), shuffled.end()); };
+  auto std_filled  = [&] { return Std(shuffled.begin(), shuffled.end()); };
+
+  bench.run("fork", "priority_queue", "push", e, n, n, [] { return Fork(); },
+            [&](Fork &pq) {
+              for (int i = 0; i < n; i++) pq.push(shuffled[i]);
+            });
+  bench.run("std", "priority_queue", "push", e, n, n, [] { return Std(); },
+            [&](Std &pq) {
+              for (int i = 0; i < n; i++) pq.push(shuffled[i]);
+            });
+  bench.run("fork", "priority_queue", "pop", e, n, n, fork_filled,
+            [&](Fork &pq) {
+              for (int i = 0; i < n; i++) pq.pop();
+            });
+  bench.run("std", "priority_queue", "pop", e, n, n, std_filled,
+            [&](Std &pq) {
+              for (int i = 0; i < n; i++) pq.pop();
+            });
+  bench.run("fork", "priority_queue", "heapify", e, n, n, [] { return Fork(); },
+            [&](Fork &pq) { pq.heapify(shuffled.begin(), shuffled.end()); });
+  bench.run("std", "priority_queue", "heapify", e, n, n, [] { return Std(); },
+            [&](Std &pq) { pq = Std(shuffled.begin(), shuffled.end()); });
+}
+
+template <typename T>
+void BenchDeque(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  ForkDeque<T> fork_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(in.values[i]);
+  }
+  std::deque<T> std_filled(in.values.begin(), in.values.end());
+  auto fork_empty = [] { return ForkDeque<T>(); };
+  auto std_empty  = [] { return std::deque<T>(); };
+  auto fork_copy  = [&] { return ForkDeque<T>(fork_filled); };
+  auto std_copy   = [&] { return std::deque<T>(std_filled); };
+
+  bench.run("fork", "deque", "push_back", e, n, n, fork_empty,
+            [&](ForkDeque<T> &d) {
+              for (int i = 0; i < n; i++) d.push_back(in.values[i]);
+            });
+  bench.run("std", "deque", "push_back", e, n, n, std_empty,
+            [&](std::deque<T> &d) {
+              for (int i = 0; i < n; i++) d.push_back(in.values[i]);
+            });
+  bench.run("fork", "deque", "push_front", e, n, n, fork_empty,
+            [&](ForkDeque<T> &d) {
+              for (int i = 0; i < n; i++) d.push_front(in.values[i]);
+            });
+  bench.run("std", "deque", "push_front", e, n, n, std_empty,
+            [&](std::deque<T> &d) {
+              for (int i = 0; i < n; i++) d.push_front(in.values[i]);
+            });
+  bench.run("fork", "deque", "pop_front", e, n, n, fork_copy,
+            [&](ForkDeque<T> &d) {
+              for (int i = 0; i < n; i++) d.pop_front();
+            });
+  bench.run("std", "deque", "pop_front", e, n, n, std_copy,
+            [&](std::deque<T> &d) {
+              for (int i = 0; i < n; i++) d.pop_front();
+            });
+  bench.run("fork", "deque", "random_access", e, n, n, fork_copy,
+            [&](ForkDeque<T> &d) {
+              for (int i = 0; i < n; i++) ForkBench::keep(d[in.random_idx[i]]);
+            });
+  bench.run("std", "deque", "random_access", e, n, n, std_copy,
+            [&](std::deque<T> &d) {
+              for (int i = 0; i < n; i++) ForkBench::keep(d[in.random_idx[i]]);
+            });
+}
+
+// keys are the elements, values their index; lookups use random_idx so
+// they hit in random order, misses probe keys that were never inserted
+template <typename T>
+void BenchHashMap(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  ForkHashMap<T, int> fork_filled;
+  std::unordered_map<T, int> std_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.insert(in.values[i], i);
+    std_filled.emplace(in.values[i], i);
+  }
+  std::vector<T> missing;
+  for (int i = 0; i < n; i++) {
+    missing.push_back(Element<T>::make(n + in.random_idx[i]));
+  }
+  auto fork_empty = [] { return ForkHashMap<T, int>(); };
+  auto std_empty  = [] { return std::unordered_map<T, int>(); };
+  auto fork_copy  = [&] { return ForkHashMap<T, int>(fork_filled); };
+  auto std_copy   = [&] { return std::unordered_map<T, int>(std_filled); };
+
+  bench.run("fork", "hash_map", "insert", e, n, n, fork_empty,
+            [&](ForkHashMap<T, int> &m) {
+              for (int i = 0; i < n; i++) m.insert(in.values[i], i);
+            });
+  bench.run("std", "hash_map", "insert", e, n, n, std_empty,
+            [&](std::unordered_map<T, int> &m) {
+              for (int i = 0; i < n; i++) m.emplace(in.values[i], i);
+            });
+  bench.run("fork", "hash_map", "insert_reserved", e, n, n, fork_empty,
+            [&](ForkHashMap<T, int> &m) {
+              m.reserve(n);
+              for (int i = 0; i < n; i++) m.insert(in.values[i], i);
+            });
+  bench.run("std", "hash_map", "insert_reserved", e, n, n, std_empty,
+            [&](std::unordered_map<T, int> &m) {
+              m.reserve(n);
+              for (int i = 0; i < n; i++) m.emplace(in.values[i], i);
+            });
+  bench.run("fork", "hash_map", "find_hit", e, n, n, fork_copy,
+            [&](ForkHashMap<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(*m.find(in.values[in.random_idx[i]]));
+              }
+            });
+  bench.run("std", "hash_map", "find_hit", e, n, n, std_copy,
+            [&](std::unordered_map<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.find(in.values[in.random_idx[i]])->second);
+              }
+            });
+  bench.run("fork", "hash_map", "find_miss", e, n, n, fork_copy,
+            [&](ForkHashMap<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.contains(missing[i]));
+              }
+            });
+  bench.run("std", "hash_map", "find_miss", e, n, n, std_copy,
+            [&](std::unordered_map<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.count(missing[i]));
+              }
+            });
+  bench.run("fork", "hash_map", "erase", e, n, n, fork_copy,
+            [&](ForkHashMap<T, int> &m) {
+              for (int i = 0; i < n; i++) m.erase(in.values[i]);
+            });
+  bench.run("std", "hash_map", "erase", e, n, n, std_copy,
+            [&](std::unordered_map<T, int> &m) {
+              for (int i = 0; i < n; i++) m.erase(in.values[i]);
+            });
+}
+
+// opt-in value index: GetIndex as a hash probe against a scan
+template <typename T>
+void BenchValueIndex(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int q   = in.queries;
+  ForkVector<T> fork_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(in.values[i]);
+  }
+  ForkVector<T> fork_bloom(fork_filled);
+  fork_filled.EnableIndex();
+  fork_bloom.EnableIndex(8 * n);  // ~8 bits per value, 3 probes
+  std::vector<T> missing;
+  for (int i = 0; i < n; i++) {
+    missing.push_back(Element<T>::make(n + in.random_idx[i]));
+  }
+  std::vector<T> std_filled(in.values);
+  auto fork_copy  = [&] { return ForkVector<T>(fork_filled); };
+  auto bloom_copy = [&] { return ForkVector<T>(fork_bloom); };
+  auto std_copy   = [&] { return std::vector<T>(std_filled); };
+
+  bench.run("fork", "value_index", "push_back", e, n, n,
+            [] {
+              ForkVector<T> v;
+              v.EnableIndex();
+              return v;
+            },
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("fork", "value_index", "search_hit", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(v.GetIndex(in.values[in.random_idx[i]]));
+              }
+            });
+  bench.run("std", "value_index", "search_hit", e, n, q, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(std::find(v.begin(), v.end(), in.probes[i]));
+              }
+            });
+  bench.run("fork", "value_index", "search_miss", e, n, n, fork_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(v.GetIndex(missing[i]));
+              }
+            });
+  bench.run("fork", "value_index", "search_miss_bloom", e, n, n, bloom_copy,
+            [&](ForkVector<T> &v) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(v.GetIndex(missing[i]));
+              }
+            });
+  bench.run("std", "value_index", "search_miss", e, n, q, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < q; i++) {
+                ForkBench::keep(std::find(v.begin(), v.end(), missing[i]));
+              }
+            });
+  bench.run("fork", "value_index", "queue_churn", e, n, n,
+            [&] {
+              ForkQueue<T> s;
+              s.enable_index();
+              for (int i = 0; i < n; i++) s.push(in.values[i]);
+              return s;
+            },
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) {
+                s.quit_head();
+                s.push(in.values[i]);
+                ForkBench::keep(s.get_index(in.values[in.random_idx[i]]));
+              }
+            });
+  // a short FIFO over a large filter: each removal drops a value, the
+  // filter is cleared only once the stale values pay for its words
+  bench.run("fork", "value_index", "queue_churn_bloom", e, n, n,
+            [&] {
+              ForkQueue<T> s;
+              s.enable_index(1 << 22);
+              for (int i = 0; i < 16; i++) s.push(in.values[i]);
+              return s;
+            },
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) {
+                s.quit_head();
+                s.push(in.values[i]);
+              }
+              ForkBench::keep(s.get_index(in.values[0]));
+            });
+  // one repeated value: both ends of its ticket list stay O(1), and a FIFO
+  // that always holds a copy keeps its ticket buffer bounded
+  bench.run("fork", "value_index", "stack_push_same", e, n, n,
+            [] {
+              ForkStack<T> s;
+              s.enable_index();
+              return s;
+            },
+            [&](ForkStack<T> &s) {
+              for (int i = 0; i < n; i++) s.push(in.values[0]);
+            });
+  bench.run("fork", "value_index", "queue_churn_same", e, n, n,
+            [&] {
+              ForkQueue<T> s;
+              s.enable_index();
+              s.push(in.values[0]);
+              s.push(in.values[0]);
+              return s;
+            },
+            [&](ForkQueue<T> &s) {
+              for (int i = 0; i < n; i++) {
+                s.push(in.values[0]);
+                s.quit_head();
+              }
+              ForkBench::keep(s.get_index(in.values[0]));
+            });
+}
+
+// read-mostly ordered lookups: sorted ForkFlatMap against std::map
+template <typename T>
+void BenchFlatMap(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  std::vector<std::pair<T, int>> pairs;
+  for (int i = 0; i < n; i++) {
+    pairs.emplace_back(in.values[in.random_idx[i]], i);
+  }
+  ForkFlatMap<T, int> fork_filled(pairs.begin(), pairs.end());
+  std::map<T, int> std_filled(pairs.begin(), pairs.end());
+  std::vector<T> missing;
+  for (int i = 0; i < n; i++) {
+    missing.push_back(Element<T>::make(n + in.random_idx[i]));
+  }
+  auto fork_copy = [&] { return ForkFlatMap<T, int>(fork_filled); };
+  auto std_copy  = [&] { return std::map<T, int>(std_filled); };
+
+  bench.run("fork", "flat_map", "build", e, n, n,
+            [] { return ForkFlatMap<T, int>(); },
+            [&](ForkFlatMap<T, int> &m) {
+              m.insert_batch(pairs.begin(), pairs.end());
+            });
+  bench.run("std", "flat_map", "build", e, n, n,
+            [] { return std::map<T, int>(); },
+            [&](std::map<T, int> &m) { m.insert(pairs.begin(), pairs.end()); });
+  bench.run("fork", "flat_map", "find_hit", e, n, n, fork_copy,
+            [&](ForkFlatMap<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(*m.find(in.values[in.random_idx[i]]));
+              }
+            });
+  bench.run("std", "flat_map", "find_hit", e, n, n, std_copy,
+            [&](std::map<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.find(in.values[in.random_idx[i]])->second);
+              }
+            });
+  bench.run("fork", "flat_map", "find_miss", e, n, n, fork_copy,
+            [&](ForkFlatMap<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.contains(missing[i]));
+              }
+            });
+  bench.run("std", "flat_map", "find_miss", e, n, n, std_copy,
+            [&](std::map<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.count(missing[i]));
+              }
+            });
+  bench.run("fork", "flat_map", "insert_batch", e, n, n, fork_copy,
+            [&](ForkFlatMap<T, int> &m) {
+              std::vector<std::pair<T, int>> batch;
+              for (int i = 0; i < n; i++) batch.emplace_back(missing[i], i);
+              m.insert_batch(batch.begin(), batch.end());
+            });
+  bench.run("std", "flat_map", "insert_batch", e, n, n, std_copy,
+            [&](std::map<T, int> &m) {
+              for (int i = 0; i < n; i++) m.emplace(missing[i], i);
+            });
+}
+
+// ordered map under churn: pooled B+-tree against std::map
+template <typename T>
+void BenchBTreeMap(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  std::map<T, int> std_filled;
+  for (int i = 0; i < n; i++) {
+    std_filled.emplace(in.values[in.random_idx[i]], i);
+  }
+  std::vector<std::pair<T, int>> sorted(std_filled.begin(), std_filled.end());
+  ForkBTreeMap<T, int> fork_filled;
+  fork_filled.bulk_load(sorted.begin(), sorted.end());
+  auto fork_copy = [&] { return ForkBTreeMap<T, int>(fork_filled); };
+  auto std_copy  = [&] { return std::map<T, int>(std_filled); };
+
+  bench.run("fork", "btree_map", "insert", e, n, n,
+            [] { return ForkBTreeMap<T, int>(); },
+            [&](ForkBTreeMap<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                m.insert(in.values[in.random_idx[i]], i);
+              }
+            });
+  bench.run("std", "btree_map", "insert", e, n, n,
+            [] { return std::map<T, int>(); },
+            [&](std::map<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                m.emplace(in.values[in.random_idx[i]], i);
+              }
+            });
+  bench.run("fork", "btree_map", "bulk_load", e, n, n,
+            [] { return ForkBTreeMap<T, int>(); },
+            [&](ForkBTreeMap<T, int> &m) {
+              m.bulk_load(sorted.begin(), sorted.end());
+            });
+  bench.run("std", "btree_map", "bulk_load", e, n, n,
+            [] { return std::map<T, int>(); },
+            [&](std::map<T, int> &m) {
+              m.insert(sorted.begin(), sorted.end());  // hinted, sorted input
+            });
+  bench.run("fork", "btree_map", "find_hit", e, n, n, fork_copy,
+            [&](ForkBTreeMap<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(*m.find(in.values[in.random_idx[i]]));
+              }
+            });
+  bench.run("std", "btree_map", "find_hit", e, n, n, std_copy,
+            [&](std::map<T, int> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m.find(in.values[in.random_idx[i]])->second);
+              }
+            });
+  bench.run("fork", "btree_map", "range_scan", e, n, n, fork_copy,
+            [&](ForkBTreeMap<T, int> &m) {
+              for (auto it = m.lower_bound(sorted[n / 4].first); it != m.end();
+                   ++it) {
+                ForkBench::keep(it.value());
+              }
+            });
+  bench.run("std", "btree_map", "range_scan", e, n, n, std_copy,
+            [&](std::map<T, int> &m) {
+              for (auto it = m.lower_bound(sorted[n / 4].first); it != m.end();
+                   ++it) {
+                ForkBench::keep(it->second);
+              }
+            });
+  bench.run("fork", "btree_map", "erase", e, n, n, fork_copy,
+            [&](ForkBTreeMap<T, int> &m) {
+              for (int i = 0; i < n; i++) m.erase(in.values[in.random_idx[i]]);
+            });
+  bench.run("std", "btree_map", "erase", e, n, n, std_copy,
+            [&](std::map<T, int> &m) {
+              for (int i = 0; i < n; i++) m.erase(in.values[in.random_idx[i]]);
+            });
+}
+
+// snapshot-per-request: a persistent update against copy-then-set
+template <typename T>
+void BenchPersistentVector(ForkBench &bench, const Inputs<T> &in) {
+  const char *e       = Element<T>::name();
+  const int n         = in.n;
+  const int snapshots = 100;
+  ForkTransientVector<T> building;
+  for (int i = 0; i < n; i++) {
+    building.push_back(in.values[i]);
+  }
+  const ForkPersistentVector<T> fork_filled = building.persistent();
+  const std::vector<T> std_filled(in.values.begin(), in.values.end());
+
+  bench.run("fork", "persistent_vector", "push_back", e, n, n,
+            [] { return ForkTransientVector<T>(); },
+            [&](ForkTransientVector<T> &v) {
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("std", "persistent_vector", "push_back", e, n, n,
+            [] { return std::vector<T>(); },
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) v.push_back(in.values[i]);
+            });
+  bench.run("fork", "persistent_vector", "random_read", e, n, n,
+            [&] { return fork_filled; },
+            [&](ForkPersistentVector<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+  bench.run("std", "persistent_vector", "random_read", e, n, n,
+            [&] { return std_filled; },
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+  bench.run("fork", "persistent_vector", "snapshot_set", e, n, snapshots,
+            [&] { return ForkVector<ForkPersistentVector<T>>(); },
+            [&](ForkVector<ForkPersistentVector<T>> &versions) {
+              ForkPersistentVector<T> current = fork_filled;
+              for (int i = 0; i < snapshots; i++) {
+                versions.push_back(current);
+                current = current.SetElement(in.random_idx[i], in.values[i]);
+              }
+            });
+  bench.run("std", "persistent_vector", "snapshot_set", e, n, snapshots,
+            [&] { return ForkVector<std::vector<T>>(); },
+            [&](ForkVector<std::vector<T>> &versions) {
+              std::vector<T> current = std_filled;
+              for (int i = 0; i < snapshots; i++) {
+                versions.push_back(current);
+                current[in.random_idx[i]] = in.values[i];
+              }
+            });
+}
+
+// editing at a cursor that drifts slowly through the middle
+template <typename T>
+void BenchGapBuffer(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int ops = n < 3000 ? n : 3000;  // the std side is O(n) per edit
+  ForkGapBuffer<T> fork_filled;
+  std::vector<T> std_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(in.values[i]);
+    std_filled.push_back(in.values[i]);
+  }
+  auto fork_copy = [&] { return ForkGapBuffer<T>(fork_filled); };
+  auto std_copy  = [&] { return std::vector<T>(std_filled); };
+
+  // type two, delete one, step the cursor back: a typist at work
+  bench.run("fork", "gap_buffer", "cursor_edit", e, n, ops, fork_copy,
+            [&](ForkGapBuffer<T> &v) {
+              int cursor = n / 2;
+              for (int i = 0; i < ops; i += 3) {
+                v.insert(cursor, in.values[i]);
+                v.insert(cursor + 1, in.values[i]);
+                v.clear(cursor + 1);
+                cursor = cursor > 0 ? cursor - 1 : 0;
+              }
+            });
+  bench.run("std", "gap_buffer", "cursor_edit", e, n, ops, std_copy,
+            [&](std::vector<T> &v) {
+              int cursor = n / 2;
+              for (int i = 0; i < ops; i += 3) {
+                v.insert(v.begin() + cursor, in.values[i]);
+                v.insert(v.begin() + cursor + 1, in.values[i]);
+                v.erase(v.begin() + cursor + 1);
+                cursor = cursor > 0 ? cursor - 1 : 0;
+              }
+            });
+  bench.run("fork", "gap_buffer", "random_read", e, n, n, fork_copy,
+            [&](ForkGapBuffer<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+  bench.run("std", "gap_buffer", "random_read", e, n, n, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+}
+
+// stable handles: erase by handle against erase by index
+template <typename T>
+void BenchSlotMap(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  const int ops = n < 3000 ? n : 3000;  // the std side is O(n) per erase
+  using Handle  = typename ForkSlotMap<T>::Handle;
+  ForkSlotMap<T> fork_filled;
+  ForkVector<Handle> handles;
+  std::vector<T> std_filled;
+  for (int i = 0; i < n; i++) {
+    handles.push_back(fork_filled.insert(in.values[i]));
+    std_filled.push_back(in.values[i]);
+  }
+  auto fork_copy = [&] { return ForkSlotMap<T>(fork_filled); };
+  auto std_copy  = [&] { return std::vector<T>(std_filled); };
+
+  bench.run("fork", "slot_map", "erase_middle", e, n, ops, fork_copy,
+            [&](ForkSlotMap<T> &m) {
+              for (int i = 0; i < ops; i++) m.erase(handles[(n / 2 + i) % n]);
+            });
+  bench.run("std", "slot_map", "erase_middle", e, n, ops, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < ops; i++) v.erase(v.begin() + v.size() / 2);
+            });
+  bench.run("fork", "slot_map", "lookup", e, n, n, fork_copy,
+            [&](ForkSlotMap<T> &m) {
+              for (int i = 0; i < n; i++) {
+                ForkBench::keep(m[handles[in.random_idx[i]]]);
+              }
+            });
+  bench.run("std", "slot_map", "lookup", e, n, n, std_copy,
+            [&](std::vector<T> &v) {
+              for (int i = 0; i < n; i++) ForkBench::keep(v[in.random_idx[i]]);
+            });
+}
+
+// whole-batch handoff between containers: node chains and vector buffers
+// change owner in O(1), the copy rows are what a conversion cost before
+template <typename T>
+void BenchHandoff(ForkBench &bench, const Inputs<T> &in) {
+  const char *e = Element<T>::name();
+  const int n   = in.n;
+  ForkList<T> fork_list;
+  ForkVector<T> fork_vector;
+  std::list<T> std_list;
+  std::vector<T> std_vector;
+  for (int i = 0; i < n; i++) {
+    fork_list.push_back(in.values[i]);
+    fork_vector.push_back(in.values[i]);
+    std_list.push_back(in.values[i]);
+    std_vector.push_back(in.values[i]);
+  }
+  auto fork_vector_copy = [&] { return ForkVector<T>(fork_vector); };
+  // the source and an empty destination, so the timed body frees nothing
+  auto fork_list_queue = [&] {
+    return std::make_pair(ForkList<T>(fork_list), ForkQueue<T>());
+  };
+  auto fork_list_stack = [&] {
+    return std::make_pair(ForkList<T>(fork_list), ForkStack<T>());
+  };
+  auto std_list_queue = [&] {
+    return std::make_pair(std::list<T>(std_list),
+                          std::queue<T, std::list<T>>());
+  };
+  auto std_list_stack = [&] {
+    return std::make_pair(std::list<T>(std_list),
+                          std::stack<T, std::list<T>>());
+  };
+  auto std_vector_stack = [&] {
+    return std::make_pair(std::vector<T>(std_vector),
+                          std::stack<T, std::vector<T>>());
+  };
+  auto fork_pipeline = [&] {
+    return std::make_pair(ForkQueue<T>(ForkList<T>(fork_list)),
+                          ForkList<T>(fork_list));
+  };
+  auto std_pipeline = [&] {
+    return std::make_pair(std::list<T>(std_list), std::list<T>(std_list));
+  };
+
+  bench.run("fork", "handoff", "list_to_queue", e, n, 1, fork_list_queue,
+            [&](std::pair<ForkList<T>, ForkQueue<T>> &p) {
+              p.second = ForkQueue<T>(std::move(p.first));
+            });
+  bench.run("fork", "handoff", "list_to_queue_copy", e, n, n, fork_list_queue,
+            [&](std::pair<ForkList<T>, ForkQueue<T>> &p) {
+              for (auto *node = p.first.data_head(); node; node = node->next) {
+                p.second.push(node->data);
+              }
+            });
+  bench.run("std", "handoff", "list_to_queue", e, n, 1, std_list_queue,
+            [&](std::pair<std::list<T>, std::queue<T, std::list<T>>> &p) {
+              p.second = std::queue<T, std::list<T>>(std::move(p.first));
+            });
+  bench.run("fork", "handoff", "list_to_stack", e, n, 1, fork_list_stack,
+            [&](std::pair<ForkList<T>, ForkStack<T>> &p) {
+              p.second = ForkStack<T>(std::move(p.first));
+            });
+  bench.run("std", "handoff", "list_to_stack", e, n, 1, std_list_stack,
+            [&](std::pair<std::list<T>, std::stack<T, std::list<T>>> &p) {
+              p.second = std::stack<T, std::list<T>>(std::move(p.first));
+            });
+  // there and back, moving into a default ForkVectorStack would also time
+  // freeing the small buffer it starts with
+  bench.run("fork", "handoff", "vector_to_stack", e, n, 1, fork_vector_copy,
+            [&](ForkVector<T> &v) {
+              ForkVectorStack<T> stack(std::move(v));
+              v = stack.release();
+            });
+  bench.run("std", "handoff", "vector_to_stack", e, n, 1, std_vector_stack,
+            [&](std::pair<std::vector<T>, std::stack<T, std::vector<T>>> &p) {
+              p.second = std::stack<T, std::vector<T>>(std::move(p.first));
+            });
+  bench.run("fork", "handoff", "splice_batch", e, n, 1, fork_pipeline,
+            [&](std::pair<ForkQueue<T>, ForkList<T>> &p) {
+              p.first.splice_back(p.second.release_chain());
+            });
+  bench.run("std", "handoff", "splice_batch", e, n, 1, std_pipeline,
+            [&](std::pair<std::list<T>, std::list<T>> &p) {
+              p.first.splice(p.first.end(), p.second);
+            });
+}
+
+// sorted 64-bit IDs: bit-packed blocks against a plain std::vector
+void BenchPackedVector(ForkBench &bench, const int &n) {
+  const char *e = "int64";
+  std::mt19937 rng(20221019u + static_cast<unsigned>(n));
+  std::vector<long long> ids;
+  long long id = 1LL << 40;
+  for (int i = 0; i < n; i++) {
+    id += 1 + rng() % 8;  // dense, sorted
+    ids.push_back(id);
+  }
+  std::vector<int> random_idx;
+  for (int i = 0; i < n; i++) {
+    random_idx.push_back(static_cast<int>(rng() % n));
+  }
+  ForkPackedVector<long long> fork_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(ids[i]);
+  }
+
+  bench.run("fork", "packed_vector", "push_back", e, n, n,
+            [] { return ForkPackedVector<long long>(); },
+            [&](ForkPackedVector<long long> &v) {
+              for (int i = 0; i < n; i++) v.push_back(ids[i]);
+            });
+  bench.run("std", "packed_vector", "push_back", e, n, n,
+            [] { return std::vector<long long>(); },
+            [&](std::vector<long long> &v) {
+              for (int i = 0; i < n; i++) v.push_back(ids[i]);
+            });
+  bench.run("fork", "packed_vector", "scan_sum", e, n, n,
+            [&] { return &fork_filled; },
+            [&](ForkPackedVector<long long> *v) {
+              long long sum = 0;
+              v->scan([&sum](const long long &value) { sum += value; });
+              ForkBench::keep(sum);
+            });
+  bench.run("std", "packed_vector", "scan_sum", e, n, n,
+            [&] { return &ids; },
+            [&](std::vector<long long> *v) {
+              long long sum = 0;
+              for (long long value : *v) sum += value;
+              ForkBench::keep(sum);
+            });
+  bench.run("fork", "packed_vector", "random_read", e, n, n,
+            [&] { return &fork_filled; },
+            [&](ForkPackedVector<long long> *v) {
+              for (int i = 0; i < n; i++) ForkBench::keep((*v)[random_idx[i]]);
+            });
+  bench.run("std", "packed_vector", "random_read", e, n, n,
+            [&] { return &ids; },
+            [&](std::vector<long long> *v) {
+              for (int i = 0; i < n; i++) ForkBench::keep((*v)[random_idx[i]]);
+            });
+}
+
+// presence masks: packed ForkVector<bool> against std::vector<bool>
+void BenchBitset(ForkBench &bench, const int &n) {
+  const char *e = "bool";
+  std::mt19937 rng(20221019u + static_cast<unsigned>(n));
+  ForkVector<bool> fork_mask;
+  std::vector<bool> std_mask;
+  for (int i = 0; i < n; i++) {
+    bool bit = rng() % 64 == 0;  // sparse, as masks usually are
+    fork_mask.push_back(bit);
+    std_mask.push_back(bit);
+  }
+  auto fork_copy = [&] { return ForkVector<bool>(fork_mask); };
+  auto std_copy  = [&] { return std::vector<bool>(std_mask); };
+
+  bench.run("fork", "bitset", "push_back", e, n, n,
+            [] { return ForkVector<bool>(); },
+            [&](ForkVector<bool> &v) {
+              for (int i = 0; i < n; i++) v.push_back((i & 7) == 0);
+            });
+  bench.run("std", "bitset", "push_back", e, n, n,
+            [] { return std::vector<bool>(); },
+            [&](std::vector<bool> &v) {
+              for (int i = 0; i < n; i++) v.push_back((i & 7) == 0);
+            });
+  bench.run("fork", "bitset", "count", e, n, n, fork_copy,
+            [&](ForkVector<bool> &v) { ForkBench::keep(v.count()); });
+  bench.run("std", "bitset", "count", e, n, n, std_copy,
+            [&](std::vector<bool> &v) {
+              ForkBench::keep(std::count(v.begin(), v.end(), true));
+            });
+  bench.run("fork", "bitset", "scan_set", e, n, n, fork_copy,
+            [&](ForkVector<bool> &v) {
+              int found = 0;
+              for (int i = v.GetIndex(true); i >= 0; i = v.find_next(i + 1)) {
+                ++found;
+              }
+              ForkBench::keep(found);
+            });
+  bench.run("std", "bitset", "scan_set", e, n, n, std_copy,
+            [&](std::vector<bool> &v) {
+              int found = 0;
+              for (int i = 0; i < n; i++) {
+                found += v[i] ? 1 : 0;
+              }
+              ForkBench::keep(found);
+            });
+  bench.run("fork", "bitset", "and", e, n, n, fork_copy,
+            [&](ForkVector<bool> &v) { v &= fork_mask; });
+  bench.run("std", "bitset", "and", e, n, n, std_copy,
+            [&](std::vector<bool> &v) {
+              for (int i = 0; i < n; i++) v[i] = v[i] && std_mask[i];
+            });
+}
+
+// one-field scans over wide records: columns against an array of structs
+class WideRecord {
+public:
+  int id;
+  double price;
+  double weight;
+  char name[48];
+};
+void BenchSoAVector(ForkBench &bench, const int &n) {
+  const char *e = "record";
+  ForkSoAVector<int, double, double> fork_filled;
+  std::vector<WideRecord> std_filled;
+  for (int i = 0; i < n; i++) {
+    fork_filled.push_back(i, i * 0.5, i * 0.25);
+    std_filled.push_back(WideRecord{i, i * 0.5, i * 0.25, {}});
+  }
+
+  bench.run("fork", "soa_vector", "push_back", e, n, n,
+            [] { return ForkSoAVector<int, double, double>(); },
+            [&](ForkSoAVector<int, double, double> &v) {
+              for (int i = 0; i < n; i++) v.push_back(i, i * 0.5, i * 0.25);
+            });
+  bench.run("std", "soa_vector", "push_back", e, n, n,
+            [] { return std::vector<WideRecord>(); },
+            [&](std::vector<WideRecord> &v) {
+              for (int i = 0; i < n; i++) {
+                v.push_back(WideRecord{i, i * 0.5, i * 0.25, {}});
+              }
+            });
+  bench.run("fork", "soa_vector", "sum_one_field", e, n, n,
+            [&] { return &fork_filled; },
+            [&](ForkSoAVector<int, double, double> *v) {
+              double sum = 0;
+              for (double price : v->column<1>()) sum += price;
+              ForkBench::keep(sum);
+            });
+  bench.run("std", "soa_vector", "sum_one_field", e, n, n,
+            [&] { return &std_filled; },
+            [&](std::vector<WideRecord> *v) {
+              double sum = 0;
+              for (const WideRecord &record : *v) sum += record.price;
+              ForkBench::keep(sum);
+            });
+}
+
+// TLB pressure: the same scans over 4 KiB pages and transparent huge pages
+// (run with --scan-mb 4096 --perf to see dTLB misses fall on big buffers)
+template <typename Vector>
+Vector FilledIota(const int &n) {
+  Vector v;
+  v.resize(n);
+  long long *data = v.GetPtr();
+  for (int i = 0; i < n; i++) data[i] = i;
+  return v;
+}
+long long ScanSum(const long long *data, const int &n) {
+  long long sum = 0;
+  for (int i = 0; i < n; i++) sum += data[i];
+  return sum;
+}
+// a dependent chain of random reads, nearly every one a TLB miss
+long long ChaseSum(const long long *data, const int &n) {
+  unsigned long long x = 88172645463325252ull;
+  long long sum        = 0;
+  for (int i = 0; i < n; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    sum += data[(x + static_cast<unsigned long long>(sum & 1)) % n];
+  }
+  return sum;
+}
+void BenchHugePages(ForkBench &bench, const int &n) {
+  const char *e = "long long";
+  using Huge    = ForkVector<long long, ForkHugePageStorage<>>;
+  using Small   = ForkVector<long long>;
+
+  bench.run("fork", "huge_page_vector", "scan", e, n, n,
+            [&] { return FilledIota<Huge>(n); },
+            [&](Huge &v) { ForkBench::keep(ScanSum(v.GetPtr(), n)); });
+  bench.run("std", "huge_page_vector", "scan", e, n, n,
+            [&] { return FilledIota<Small>(n); },
+            [&](Small &v) { ForkBench::keep(ScanSum(v.GetPtr(), n)); });
+  bench.run("fork", "huge_page_vector", "random_read", e, n, n,
+            [&] { return FilledIota<Huge>(n); },
+            [&](Huge &v) { ForkBench::keep(ChaseSum(v.GetPtr(), n)); });
+  bench.run("std", "huge_page_vector", "random_read", e, n, n,
+            [&] { return FilledIota<Small>(n); },
+            [&](Small &v) { ForkBench::keep(ChaseSum(v.GetPtr(), n)); });
+}
+
+// the baseline for shared appends: a vector behind one mutex
+template <typename T>
+class LockedVector {
+public:
+  std::mutex mtx;
+  std::vector<T> data;
+};
+
+// split [0, n) over several threads and run body(i) for every index
+template <typename Body>
+void RunThreads(const int &threads, const int &n, Body body) {
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++) {
+    pool.emplace_back([&, t] {
+      long long first = static_cast<long long>(n) * t / threads;
+      long long last  = static_cast<long long>(n) * (t + 1) / threads;
+      for (long long i = first; i < last; i++) {
+        body(static_cast<int>(i));
+      }
+    });
+  }
+  for (auto &thread : pool) {
+    thread.join();
+  }
+}
+
+template <typename T>
+void BenchConcurrentVector(ForkBench &bench, const Inputs<T> &in) {
+  const char *e     = Element<T>::name();
+  const int n       = in.n;
+  const int threads = 4;
+
+  bench.run("fork", "concurrent_vector", "push_back_4_threads", e, n, n,
+            [] { return ForkConcurrentVector<T>(); },
+            [&](ForkConcurrentVector<T> &v) {
+              RunThreads(threads, n, [&](int i) { v.push_back(in.values[i]); });
+            });
+  bench.run("std", "concurrent_vector", "push_back_4_threads", e, n, n,
+            [] { return LockedVector<T>(); },
+            [&](LockedVector<T> &v) {
+              RunThreads(threads, n, [&](int i) {
+                std::lock_guard<std::mutex> lock(v.mtx);
+                v.data.push_back(in.values[i]);
+              });
+            });
+}
+
+template <typename T>
+void BenchAll(ForkBench &bench, const int &n) {
+  Inputs<T> in(n, 20221019u + static_cast<unsigned>(n));
+  BenchVector<T>(bench, in);
+  BenchList<T>(bench, in);
+  BenchStack<T>(bench, in);
+  BenchQueue<T>(bench, in);
+  BenchPriorityQueue<T>(bench, in);
+  BenchDeque<T>(bench, in);
+  BenchConcurrentVector<T>(bench, in);
+  BenchHashMap<T>(bench, in);
+  BenchFlatMap<T>(bench, in);
+  BenchBTreeMap<T>(bench, in);
+  BenchPersistentVector<T>(bench, in);
+  BenchGapBuffer<T>(bench, in);
+  BenchSlotMap<T>(bench, in);
+  BenchValueIndex<T>(bench, in);
+  BenchHandoff<T>(bench, in);
+}
+
+int main(int argc, char **argv) {
+  bool quick        = false;
+  bool perf         = false;
+  int repetitions   = 5;
+  long long scan_mb = 0;  // extra huge_page_vector run, 0 for none
+  std::string filter;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--quick") == 0) {
+      quick = true;
+    } else if (std::strcmp(argv[i], "--perf") == 0) {
+      perf = true;
+    } else if (std::strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+      repetitions = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--scan-mb") == 0 && i + 1 < argc) {
+      scan_mb = std::atoll(argv[++i]);
+    } else {
+      filter = argv[i];
+    }
+  }
+  ForkBench bench(std::cout, filter, quick ? 1 : repetitions, perf);
+  bench.header();
+  ForkVector<int> sizes;
+  sizes.push_back(1000);
+  if (!quick) {
+    sizes.push_back(100000);
+  }
+  for (int i = 0; i < sizes.GetSize(); i++) {
+    BenchAll<int>(bench, sizes[i]);
+    BenchAll<std::string>(bench, sizes[i]);
+    BenchBitset(bench, sizes[i]);
+    BenchSoAVector(bench, sizes[i]);
+    BenchPackedVector(bench, sizes[i]);
+    BenchHugePages(bench, sizes[i]);
+  }
+  if (scan_mb > 0) {
+    long long n = (scan_mb << 20) / static_cast<long long>(sizeof(long long));
+    BenchHugePages(bench, static_cast<int>(std::min<long long>(n, INT_MAX)));
+  }
+  return 0;
+}
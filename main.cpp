@@ -1,9 +1,33 @@
 ﻿#include <iostream>
+#include <thread>
 
+#include "ForkBitset.hpp"
+#include "ForkBlockingQueue.hpp"
+#include "ForkBTreeMap.hpp"
+#include "ForkChain.hpp"
+#include "ForkChannel.hpp"
+#include "ForkConcurrentVector.hpp"
+#include "ForkDeque.hpp"
+#include "ForkHashMap.hpp"
+#include "ForkExport.hpp"
+#include "ForkFlatMap.hpp"
+#include "ForkGapBuffer.hpp"
 #include "ForkList.hpp"
+#include "ForkLoader.hpp"
+#include "ForkLRUCache.hpp"
+#include "ForkPackedVector.hpp"
+#include "ForkPersistentVector.hpp"
+#include "ForkPriorityQueue.hpp"
 #include "ForkQueue.hpp"
+#include "ForkSlotMap.hpp"
+#include "ForkSoAVector.hpp"
 #include "ForkStack.hpp"
+#include "ForkStats.hpp"
+#include "ForkStorage.hpp"
+#include "ForkTaskScheduler.hpp"
+#include "ForkValueIndex.hpp"
 #include "ForkVector.hpp"
+#include "ForkVectorAdaptor.hpp"
 
 using namespace std;
 
@@ -22,6 +46,19 @@ void TestForkVector() {
   cout << endl;
   cout << "size: " << forkVec.GetSize() << endl;
   cout << "capacity: " << forkVec.GetCapacity() << endl;
+  // built by the compiler, nothing runs at startup
+  constexpr auto squares = fork_static_array<[] {
+    ForkVector<int> table;
+    for (int i = 0; i < 8; i++) {
+      table.push_back(i * i);
+    }
+    return table;
+  }>();
+  cout << "compile-time table: ";
+  for (int square : squares) {
+    cout << square << " ";
+  }
+  cout << endl;
   cout << "================================" << endl;
   cout << endl;
 }
@@ -77,6 +114,519 @@ void TestForkStack() {
   cout << endl;
 }
 
+void TestForkBlockingQueue() {
+  cout << "Test ForkBlockingQueue >> " << endl;
+  cout << "================================" << endl;
+  ForkBlockingQueue<int> blockingQueue(4);
+  std::thread producer([&blockingQueue] {
+    for (int i = 1; i <= 10; i++) {
+      blockingQueue.push(i);
+    }
+    blockingQueue.close();
+  });
+  ForkVector<int> batch;
+  int batches = 0;
+  while (blockingQueue.drain_into(batch, 3) > 0) {
+    ++batches;
+  }
+  producer.join();
+  batch.echo();
+  cout << "drained in " << batches << " batches" << endl;
+  int value      = 0;
+  bool got_value = blockingQueue.pop_for(value, std::chrono::milliseconds(1));
+  cout << "pop_for on closed queue: " << got_value << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkPriorityQueue() {
+  cout << "Test ForkPriorityQueue >> " << endl;
+  cout << "================================" << endl;
+  int init[] = {5, 1, 8, 3, 9, 2};
+  ForkPriorityQueue<int> maxHeap(init, init + 6);
+  maxHeap.echo();
+  cout << "top: " << maxHeap.top() << endl;
+  ForkPriorityQueue<int, std::greater<int>> minHeap;
+  minHeap.push(7);
+  auto handle = minHeap.push(6);
+  minHeap.push(4);
+  minHeap.decrease_key(handle, 1);
+  cout << "min-heap pops: ";
+  while (!minHeap.is_empty()) {
+    cout << minHeap.top() << " ";
+    minHeap.pop();
+  }
+  cout << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+// naive fork-join fibonacci, one task per call above the cutoff
+long long ParallelFib(ForkTaskScheduler &scheduler, const int &n) {
+  if (n < 16) {
+    return n < 2 ? n : ParallelFib(scheduler, n - 1) +
+                           ParallelFib(scheduler, n - 2);
+  }
+  long long left  = 0;
+  long long right = 0;
+  ForkTaskGroup group(scheduler);
+  group.run([&] { left = ParallelFib(scheduler, n - 1); });
+  group.run([&] { right = ParallelFib(scheduler, n - 2); });
+  group.wait();
+  return left + right;
+}
+
+void TestForkTaskScheduler() {
+  cout << "Test ForkTaskScheduler >> " << endl;
+  cout << "================================" << endl;
+  ForkTaskScheduler scheduler;
+  cout << "workers: " << scheduler.get_num_workers() << endl;
+  cout << "fib(25): " << ParallelFib(scheduler, 25) << endl;
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 1000; i++) {
+    scheduler.submit([&counter] { counter.fetch_add(1); });
+  }
+  scheduler.wait_idle();
+  cout << "submitted tasks run: " << counter.load() << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+ForkDetached ChannelProducer(ForkChannel<int> &channel, const int count) {
+  for (int i = 1; i <= count; i++) {
+    co_await channel.push(i);
+  }
+  channel.close();
+}
+
+ForkDetached ChannelConsumer(ForkChannel<int> &channel, ForkVector<int> &out) {
+  while (auto value = co_await channel.pop()) {
+    out.push_back(*value);
+  }
+}
+
+void TestForkChannel() {
+  cout << "Test ForkChannel >> " << endl;
+  cout << "================================" << endl;
+  ForkChannel<int> channel(2);
+  ForkVector<int> received;
+  ChannelConsumer(channel, received);  // suspends on the empty channel
+  ChannelProducer(channel, 6);         // every push resumes the consumer
+  received.echo();
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkDeque() {
+  cout << "Test ForkDeque >> " << endl;
+  cout << "================================" << endl;
+  ForkDeque<int> forkDeque;
+  forkDeque.push_back(1);
+  forkDeque.push_back(2);
+  forkDeque.push_front(0);
+  forkDeque.push_front(-1);
+  forkDeque.echo();
+  forkDeque.pop_front();
+  forkDeque.pop_back();
+  forkDeque.echo();
+  cout << "element 1: " << forkDeque[1] << endl;
+  cout << "block size: " << ForkDeque<int>::block_size << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkStats() {
+  cout << "Test ForkStats >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<int> forkVec;
+  for (int i = 0; i < 100; i++) {
+    forkVec.push_back(i);
+  }
+  forkVec.GetIndex(99);
+  ForkStatsRegistry::instance().dump(cout);
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkExport() {
+  cout << "Test ForkExport >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<double> forkVec;
+  for (int i = 0; i < 5; i++) {
+    forkVec.push_back(i * 0.5);
+  }
+  ForkList<std::string> forkList;
+  forkList.push_back("plain");
+  forkList.push_back("with,comma");
+  forkList.push_back("with \"quote\"");
+  ForkExport csv(ForkLayout::csv);
+  forkVec.export_to(csv);
+  forkList.export_to(csv);
+  csv.flush(stdout);
+  ForkExport lines(ForkLayout::lines);
+  forkVec.export_to(lines);
+  std::string text;
+  lines.flush(text);
+  cout << "lines layout: " << text.size() << " bytes" << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkLoader() {
+  cout << "Test ForkLoader >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<int> forkVec;
+  for (int i = 0; i < 1000; i++) {
+    forkVec.push_back(i * 3);
+  }
+  std::string path = "ForkLoader_demo.txt";
+  FILE *file       = fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    cout << "cannot create " << path << endl;
+    return;
+  }
+  ForkExport lines(ForkLayout::lines);
+  forkVec.export_to(lines);
+  lines.flush(file);
+  fclose(file);
+  ForkLoadOptions options;
+  options.threads   = 4;
+  options.min_chunk = 256;
+  ForkVector<int> loaded;
+  ForkLoader::load_text(path, loaded, options);
+  remove(path.c_str());
+  cout << "loaded " << loaded.GetSize() << " numbers, equal: "
+       << (loaded == forkVec ? "yes" : "no") << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkConcurrentVector() {
+  cout << "Test ForkConcurrentVector >> " << endl;
+  cout << "================================" << endl;
+  ForkConcurrentVector<int> forkVec;
+  ForkVector<std::thread *> writers;
+  for (int t = 0; t < 4; t++) {
+    writers.push_back(new std::thread([&forkVec, t] {
+      for (int i = 0; i < 1000; i++) {
+        forkVec.push_back(t * 1000 + i);
+      }
+    }));
+  }
+  int *first = nullptr;
+  while (first == nullptr) {
+    if (!forkVec.is_empty()) {
+      first = &forkVec[0];  // stays valid while the writers keep going
+    }
+  }
+  for (int t = 0; t < writers.GetSize(); t++) {
+    writers[t]->join();
+    delete writers[t];
+  }
+  cout << "size: " << forkVec.GetSize() << endl;
+  cout << "capacity: " << forkVec.GetCapacity() << endl;
+  cout << "first element unmoved: " << (first == &forkVec[0] ? "yes" : "no")
+       << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkBitset() {
+  cout << "Test ForkBitset >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<bool> evens;  // packed, 64 flags per word
+  ForkVector<bool> thirds;
+  for (int i = 0; i < 24; i++) {
+    evens.push_back(i % 2 == 0);
+    thirds.push_back(i % 3 == 0);
+  }
+  evens.echo();
+  thirds.echo();
+  ForkVector<bool> both = evens & thirds;
+  both.echo();
+  cout << "first set: " << both.GetIndex(true)
+       << ", next set: " << both.find_next(1) << endl;
+  both[1] = true;
+  cout << "after both[1] = true, count: " << both.count() << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkHashMap() {
+  cout << "Test ForkHashMap >> " << endl;
+  cout << "================================" << endl;
+  ForkHashMap<std::string, int> forkMap;
+  forkMap.insert("one", 1);
+  forkMap.insert("two", 2);
+  forkMap["three"] = 3;
+  forkMap.insert_or_assign("two", 22);
+  forkMap.echo();
+  std::string_view key = "three";  // looked up without building a string
+  cout << "three: " << *forkMap.find(key) << endl;
+  cout << "contains one: " << (forkMap.contains("one") ? "yes" : "no") << endl;
+  forkMap.erase("one");
+  cout << "size: " << forkMap.get_size()
+       << ", capacity: " << forkMap.get_capacity() << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkFlatMap() {
+  cout << "Test ForkFlatMap >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<std::pair<int, std::string>> unsorted;
+  unsorted.push_back({5, "five"});
+  unsorted.push_back({2, "two"});
+  unsorted.push_back({9, "nine"});
+  unsorted.push_back({2, "deux"});  // duplicate, the first one is kept
+  ForkFlatMap<int, std::string> forkMap(unsorted.GetPtr(),
+                                        unsorted.GetPtr() + unsorted.GetSize());
+  forkMap.echo();
+  ForkVector<std::pair<int, std::string>> batch;
+  batch.push_back({7, "seven"});
+  batch.push_back({1, "one"});
+  forkMap.insert_batch(batch.GetPtr(), batch.GetPtr() + batch.GetSize());
+  forkMap[3] = "three";
+  forkMap.erase(9);
+  forkMap.echo();
+  cout << "first key >= 4: " << forkMap.GetKey(forkMap.lower_bound(4)) << endl;
+  int raw[] = {4, 1, 4, 8, 1};
+  ForkFlatSet<int> forkSet(raw, raw + 5);
+  forkSet.insert(6);
+  forkSet.echo();
+  cout << "contains 8: " << (forkSet.contains(8) ? "yes" : "no") << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkBTreeMap() {
+  cout << "Test ForkBTreeMap >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<std::pair<int, std::string>> sorted;
+  for (int i = 0; i < 10; i++) {
+    sorted.push_back({i * 10, "v" + std::to_string(i * 10)});
+  }
+  ForkBTreeMap<int, std::string> forkTree;
+  forkTree.bulk_load(sorted.GetPtr(), sorted.GetPtr() + sorted.GetSize());
+  forkTree.insert(45, "v45");
+  forkTree[5] = "v5";
+  forkTree.erase(90);
+  forkTree.echo();
+  cout << "range [30, 60): ";
+  for (auto it = forkTree.lower_bound(30); it != forkTree.lower_bound(60);
+       ++it) {
+    cout << it.key() << " ";
+  }
+  cout << endl;
+  cout << "first key > 45: " << forkTree.upper_bound(45).key()
+       << ", size: " << forkTree.get_size() << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkLRUCache() {
+  cout << "Test ForkLRUCache >> " << endl;
+  cout << "================================" << endl;
+  ForkLRUCache<std::string, int> forkCache(3);
+  forkCache.put("a", 1);
+  forkCache.put("b", 2);
+  forkCache.put("c", 3);
+  forkCache.get("a");     // a becomes the most recent
+  forkCache.put("d", 4);  // evicts b
+  forkCache.echo();
+  cout << "b cached: " << (forkCache.contains("b") ? "yes" : "no") << endl;
+  forkCache.get("b");
+  cout << "hits: " << forkCache.hits() << ", misses: " << forkCache.misses()
+       << ", evictions: " << forkCache.evictions() << endl;
+  ForkLRUCache<int, int> forkScan(4, 0, ForkCachePolicy::slru);
+  forkScan.put(1, 10);
+  forkScan.get(1);  // protected after a second use
+  for (int i = 100; i < 110; i++) {
+    forkScan.put(i, i);  // a one-off scan only churns probation
+  }
+  cout << "1 survives the scan: " << (forkScan.contains(1) ? "yes" : "no")
+       << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkPersistentVector() {
+  cout << "Test ForkPersistentVector >> " << endl;
+  cout << "================================" << endl;
+  ForkTransientVector<int> batch;  // batch edits happen in place
+  for (int i = 0; i < 5; i++) {
+    batch.push_back(i * 10);
+  }
+  ForkPersistentVector<int> v1 = batch.persistent();
+  ForkPersistentVector<int> v2 = v1.SetElement(2, 99).push_back(50);
+  ForkPersistentVector<int> v3 = v2.pop_back().pop_back();
+  v1.echo();  // untouched by the updates below it
+  v2.echo();
+  v3.echo();
+  ForkPersistentVector<int> snapshot = v2;  // O(1), shares every node
+  cout << "snapshot size: " << snapshot.GetSize() << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkSoAVector() {
+  cout << "Test ForkSoAVector >> " << endl;
+  cout << "================================" << endl;
+  ForkSoAVector<int, double> forkSoA;  // id column, price column
+  forkSoA.push_back(1, 9.5);
+  forkSoA.push_back(2, 3.25);
+  forkSoA.push_back(3, 7.0);
+  forkSoA.echo();
+  double total = 0;
+  for (double price : forkSoA.column<1>()) {  // streams the prices only
+    total += price;
+  }
+  cout << "total price: " << total << endl;
+  for (auto [id, price] : forkSoA.rows()) {
+    price *= id;
+  }
+  forkSoA.echo();
+  cout << "size: " << forkSoA.GetSize()
+       << ", capacity: " << forkSoA.GetCapacity() << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkStorage() {
+  cout << "Test ForkStorage >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<float, ForkAlignedStorage<64>> forkAligned;  // cache-line start
+  for (int i = 0; i < 8; i++) {
+    forkAligned.push_back(i * 0.5f);
+  }
+  forkAligned.echo();
+  auto aligned = reinterpret_cast<std::uintptr_t>(forkAligned.GetPtr());
+  cout << "64-byte aligned: " << (aligned % 64 == 0 ? "yes" : "no") << endl;
+  ForkVector<long long, ForkHugePageStorage<>> forkHuge;
+  forkHuge.resize(1 << 20);  // 8 MiB, backed by 2 MiB pages where allowed
+  auto huge = reinterpret_cast<std::uintptr_t>(forkHuge.GetPtr());
+  cout << "huge page aligned: "
+       << (huge % ForkHugePageStorage<>::huge_page == 0 ? "yes" : "no") << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkGapBuffer() {
+  cout << "Test ForkGapBuffer >> " << endl;
+  cout << "================================" << endl;
+  ForkGapBuffer<char> forkGap;
+  for (char c : std::string("helo world")) {
+    forkGap.push_back(c);
+  }
+  forkGap.insert(3, 'l');  // the gap jumps to 3 once
+  forkGap.insert(4, ',');  // then every edit at the cursor is O(1)
+  forkGap.clear(4);        // and so is deleting right after it
+  forkGap.echo();
+  cout << "cursor: " << forkGap.GetCursor() << ", size: " << forkGap.GetSize()
+       << ", element 4: " << forkGap[4] << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkSlotMap() {
+  cout << "Test ForkSlotMap >> " << endl;
+  cout << "================================" << endl;
+  ForkSlotMap<std::string> forkSlots;
+  auto alice = forkSlots.insert("alice");
+  auto bob   = forkSlots.insert("bob");
+  auto carol = forkSlots.insert("carol");
+  forkSlots.erase(alice);  // carol moves into the hole, no handle changes
+  forkSlots.echo();
+  cout << "carol: " << forkSlots[carol] << ", bob: " << forkSlots[bob] << endl;
+  auto dave = forkSlots.insert("dave");  // reuses alice's slot
+  cout << "alice still valid: " << (forkSlots.contains(alice) ? "yes" : "no")
+       << ", dave: " << forkSlots[dave] << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkValueIndex() {
+  cout << "Test ForkValueIndex >> " << endl;
+  cout << "================================" << endl;
+  ForkVector<int> forkVec;
+  forkVec.EnableIndex(256);  // with a Bloom filter
+  for (int i = 0; i < 8; i++) {
+    forkVec.push_back(i * i % 7);
+  }
+  forkVec.echo();
+  cout << "index of 2: " << forkVec.GetIndex(2)
+       << ", index of 5: " << forkVec.GetIndex(5) << endl;
+  forkVec.SetElement(3, 5);
+  forkVec.clear(0);
+  cout << "after SetElement(3, 5) and clear(0), index of 5: "
+       << forkVec.GetIndex(5) << endl;
+  ForkQueue<std::string> forkQueue;
+  forkQueue.enable_index();
+  forkQueue.push("a");
+  forkQueue.push("b");
+  forkQueue.push("c");
+  forkQueue.quit_head();
+  cout << "queue index of c: " << forkQueue.get_index("c")
+       << ", of a: " << forkQueue.get_index("a") << endl;
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkPackedVector() {
+  cout << "Test ForkPackedVector >> " << endl;
+  cout << "================================" << endl;
+  ForkPackedVector<long long> forkIds;
+  long long id = 1000000000000LL;
+  for (int i = 0; i < 1000; i++) {
+    id += 1 + i % 3;  // sorted, small gaps
+    forkIds.push_back(id);
+  }
+  cout << "values: " << forkIds.GetSize() << ", blocks: "
+       << forkIds.GetBlockCount() << ", bytes: " << forkIds.GetBytes()
+       << " (plain: " << forkIds.GetSize() * sizeof(long long) << ")"
+       << endl;
+  cout << "element 500: " << forkIds[500] << ", last: " << forkIds[999]
+       << endl;
+  ForkPackedVector<int> forkCounters;
+  for (int i = 0; i < 10; i++) {
+    forkCounters.push_back(i * 7 % 5);
+  }
+  forkCounters.echo();
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+void TestForkChain() {
+  cout << "Test ForkChain >> " << endl;
+  cout << "================================" << endl;
+  ForkList<int> forkBatch;
+  for (int i = 1; i <= 5; i++) {
+    forkBatch.push_back(i);
+  }
+  ForkQueue<int> forkQueue(std::move(forkBatch));  // no node is copied
+  ForkList<int> forkMore;
+  forkMore.push_back(6);
+  forkMore.push_back(7);
+  forkQueue.splice_back(forkMore.release_chain());
+  cout << "list size after handoff: " << forkBatch.GetSize() << endl;
+  forkQueue.echo();
+  cout << "fetched: " << forkQueue.fetch_head() << endl;
+  ForkStack<int> forkStack(std::move(forkQueue));  // head on top
+  forkStack.echo();
+  ForkVector<int> forkBuffer;
+  for (int i = 10; i <= 14; i++) {
+    forkBuffer.push_back(i);
+  }
+  ForkVectorQueue<int> forkVectorQueue(std::move(forkBuffer));
+  cout << "fetched: " << forkVectorQueue.fetch_head() << endl;
+  forkVectorQueue.echo();
+  ForkVectorStack<int> forkVectorStack(forkVectorQueue.release());
+  forkVectorStack.push(15);
+  forkVectorStack.echo();
+  cout << "================================" << endl;
+  cout << endl;
+}
+
 // test in main() function
 int main() {
   // test ForkVector
@@ -87,6 +637,50 @@ int main() {
   TestForkQueue();
   // test ForkStack
   TestForkStack();
+  // test ForkBlockingQueue
+  TestForkBlockingQueue();
+  // test ForkTaskScheduler
+  TestForkTaskScheduler();
+  // test ForkPriorityQueue
+  TestForkPriorityQueue();
+  // test ForkChannel
+  TestForkChannel();
+  // test ForkDeque
+  TestForkDeque();
+  // test ForkStats
+  TestForkStats();
+  // test ForkExport
+  TestForkExport();
+  // test ForkLoader
+  TestForkLoader();
+  // test ForkConcurrentVector
+  TestForkConcurrentVector();
+  // test ForkBitset
+  TestForkBitset();
+  // test ForkHashMap
+  TestForkHashMap();
+  // test ForkFlatMap
+  TestForkFlatMap();
+  // test ForkBTreeMap
+  TestForkBTreeMap();
+  // test ForkLRUCache
+  TestForkLRUCache();
+  // test ForkPersistentVector
+  TestForkPersistentVector();
+  // test ForkSoAVector
+  TestForkSoAVector();
+  // test ForkStorage
+  TestForkStorage();
+  // test ForkGapBuffer
+  TestForkGapBuffer();
+  // test ForkSlotMap
+  TestForkSlotMap();
+  // test ForkValueIndex
+  TestForkValueIndex();
+  // test ForkPackedVector
+  TestForkPackedVector();
+  // test ForkChain
+  TestForkChain();
   cout << "End of program, press enter to exit ... " << endl;
   getchar_unlocked();
 }